@@ -0,0 +1,424 @@
+/*
+ * bench.cpp - Host micro-benchmarks for BlinkyTree (pio run -e native)
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ *
+ * Runs the real Lighting/Audio/Sensors code on top of the hardware mock:
+ * candle frames, melody decoding and breath detection over an ADC trace.
+ *
+ * Usage: program [-o trace_dir] [adc_trace.txt]
+ *   adc_trace.txt - one ADC reading per line at 1kHz ('#' starts a comment),
+ *                   a synthetic idle/breath/blow trace is used without it
+ *   -o trace_dir  - write candle.csv, melody.csv and breath.csv output traces
+ *
+ * ns/op are host numbers: compare them between revisions, not with the chip.
+ * The synthetic trace also checks the song triggers and exits non-zero on a mismatch.
+ * With FEATURE_AUDIO_DDS (pio run -e native_dds) the two-staff fixture in bench/fixtures
+ * checks that melody and harmony stay on one timeline.
+ */
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "../config/config.h"
+#include "../lib/Lighting/lighting.h"
+#include "../lib/Audio/audio.h"
+#include "../lib/Sensors/sensors.h"
+#include "mock/hardware_mock.h"
+
+// ============================================================================
+// BENCHMARK HELPERS
+// ============================================================================
+
+#define BENCH_CANDLE_FRAMES 20000
+#define BENCH_MELODY_ROUNDS 20
+#define BENCH_SYNTHETIC_MS 20000
+#define BENCH_SYNTHETIC_SONGS 2   // Songs the synthetic trace starts (light blow, blow after the cooldown)
+#define BENCH_SYNTHETIC_STOPS 1   // ...and stops with a new blow
+#define BENCH_MIN_SONG_MS 1000    // Shorter songs were stopped by the blow that started them
+
+typedef std::chrono::steady_clock bench_clock_t;
+
+typedef struct
+{
+    const char *name;
+    uint64_t ns;
+    uint32_t ops;
+} bench_result_t;
+
+static std::vector<bench_result_t> g_results;
+static const char *g_trace_dir = NULL;
+
+static uint64_t bench_ns_since(bench_clock_t::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock_t::now() - start).count();
+}
+
+static void bench_report(const char *name, uint64_t ns, uint32_t ops)
+{
+    bench_result_t result = {name, ns, ops};
+    g_results.push_back(result);
+}
+
+static FILE *bench_open_trace(const char *file, const char *header)
+{
+    if (!g_trace_dir)
+    {
+        return NULL;
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", g_trace_dir, file);
+    FILE *trace = fopen(path, "w");
+    if (!trace)
+    {
+        fprintf(stderr, "cannot write %s\n", path);
+        return NULL;
+    }
+    fprintf(trace, "%s\n", header);
+    return trace;
+}
+
+// ============================================================================
+// CANDLE EFFECT
+// ============================================================================
+
+static void bench_candle(void)
+{
+    mock_reset();
+    lighting_init();
+    lighting_set_effect(LIGHTING_EFFECT_CANDLE);
+
+    FILE *trace = bench_open_trace("candle.csv", "ms,led_1er,led_3er,led_4er,led_5er");
+
+    uint64_t frame_ns = 0;
+    uint64_t slew_ns = 0;
+    uint32_t slews = 0;
+    for (uint32_t frame = 0; frame < BENCH_CANDLE_FRAMES; frame++)
+    {
+        // A breath boost now and then, like sensors_update() would set it
+        lighting_set_breath_boost((frame % 40) < 4 ? 60 : 0);
+
+        bench_clock_t::time_point start = bench_clock_t::now();
+        lighting_update();
+        frame_ns += bench_ns_since(start);
+
+        for (uint16_t ms = 0; ms < LIGHTING_FRAME_MS; ms += LIGHTING_SLEW_MS)
+        {
+            mock_advance_ms(LIGHTING_SLEW_MS);
+
+            start = bench_clock_t::now();
+            lighting_interpolate();
+            slew_ns += bench_ns_since(start);
+            slews++;
+
+            if (trace)
+            {
+                fprintf(trace, "%u,%u,%u,%u,%u\n", (unsigned)hardware_get_millis(),
+                        mock_led_brightness[LED_1ER_RING], mock_led_brightness[LED_3ER_RING],
+                        mock_led_brightness[LED_4ER_RING], mock_led_brightness[LED_5ER_RING]);
+            }
+        }
+    }
+
+    bench_report("candle keyframe (lighting_update)", frame_ns, BENCH_CANDLE_FRAMES);
+    bench_report("candle slew (lighting_interpolate)", slew_ns, slews);
+
+    if (trace)
+    {
+        fclose(trace);
+    }
+}
+
+// ============================================================================
+// MELODY DECODING
+// ============================================================================
+
+static void bench_melodies(void)
+{
+    mock_reset();
+    lighting_init();
+    audio_init();
+
+    FILE *trace = bench_open_trace("melody.csv", "ms,melody,frequency,led_1er,led_3er,led_4er,led_5er");
+
+    uint64_t update_ns = 0;
+    uint64_t note_ns = 0;
+    uint64_t envelope_ns = 0;
+    uint32_t updates = 0;
+    uint32_t notes = 0;
+    for (uint8_t round = 0; round < BENCH_MELODY_ROUNDS; round++)
+    {
+        for (uint8_t id = MELODY_NONE + 1; id < MELODY_COUNT; id++)
+        {
+            audio_start_melody((melody_id_t)id);
+            uint16_t last_frequency = 0;
+            while (audio_is_song_playing())
+            {
+                mock_advance_ms(1);
+
+                uint32_t notes_before = mock_audio_notes;
+                bench_clock_t::time_point start = bench_clock_t::now();
+                audio_update();
+                uint64_t ns = bench_ns_since(start);
+                update_ns += ns;
+                updates++;
+                if (mock_audio_notes != notes_before)
+                {
+                    note_ns += ns; // Step that decoded and started the next note
+                }
+
+                // Audio-reactive envelopes, stepped by the 1ms interpolation task as on the chip
+                start = bench_clock_t::now();
+                lighting_interpolate();
+                envelope_ns += bench_ns_since(start);
+
+                if (trace && round == 0 && (mock_audio_frequency != last_frequency || hardware_get_millis() % AUDIO_ENVELOPE_STEP_MS == 0))
+                {
+                    fprintf(trace, "%u,%u,%u,%u,%u,%u,%u\n", (unsigned)hardware_get_millis(), id, mock_audio_frequency,
+                            mock_led_brightness[LED_1ER_RING], mock_led_brightness[LED_3ER_RING],
+                            mock_led_brightness[LED_4ER_RING], mock_led_brightness[LED_5ER_RING]);
+                }
+                last_frequency = mock_audio_frequency;
+            }
+            notes += mock_audio_notes;
+            mock_audio_notes = 0;
+        }
+    }
+
+    bench_report("melody step (audio_update, 1ms)", update_ns, updates);
+    bench_report("melody note (decode + start)", note_ns, notes);
+    bench_report("note envelopes (lighting_interpolate)", envelope_ns, updates);
+
+    if (trace)
+    {
+        fclose(trace);
+    }
+}
+
+#if FEATURE_AUDIO_DDS
+// ============================================================================
+// HARMONY (two-staff fixture, linked for native builds only)
+// ============================================================================
+
+// bench/fixtures/two_voice.musicxml repeats one phrase per staff, so both streams are packed
+// as segment calls; every harmony note starts together with a higher melody note
+// Returns false when the harmony drifts off the melody timeline, plays melody segments or stops early
+static bool bench_harmony(void)
+{
+    mock_reset();
+    lighting_init();
+    audio_init();
+
+    audio_song_t song;
+    memcpy_P(&song, get_melody_data(MELODY_TWO_VOICE), sizeof(song));
+    bool harmony_calls = song.harmony && pgm_read_byte(song.harmony) == AUDIO_PITCH_SEGMENT;
+
+    uint32_t off_timeline = 0;
+    uint32_t above_melody = 0;
+    audio_start_melody(MELODY_TWO_VOICE);
+    while (audio_is_song_playing())
+    {
+        mock_advance_ms(1);
+
+        uint32_t harmony_before = mock_dds_notes[1];
+        audio_update();
+        if (mock_dds_notes[1] != harmony_before && mock_dds_note_ms[0] != hardware_get_millis())
+        {
+            off_timeline++;
+        }
+        else if (mock_dds_notes[1] != harmony_before && mock_dds_step[1] >= mock_dds_step[0])
+        {
+            above_melody++; // Bass staff note decoded from a melody segment
+        }
+    }
+
+    printf("harmony fixture: %u of %u notes, %u off the melody timeline, %u not below it, %s\n",
+           (unsigned)mock_dds_notes[1], song.harmony_count, (unsigned)off_timeline, (unsigned)above_melody,
+           harmony_calls ? "segment calls" : "no segment call");
+
+    if (!harmony_calls || mock_dds_notes[1] != song.harmony_count || off_timeline != 0 || above_melody != 0)
+    {
+        fprintf(stderr, "harmony fixture: expected all notes below the melody on its timeline, played from segment calls\n");
+        return false;
+    }
+    return true;
+}
+#endif
+
+// ============================================================================
+// BREATH DETECTION
+// ============================================================================
+
+// Idle peak-detector level with rare 1-count noise, a light blow at 3s, strong blows at 8s and 14s
+// Expected: the light blow starts a song, the 8s blow stops it, the 14s blow starts the next one
+static void bench_synthetic_trace(std::vector<uint16_t> *samples)
+{
+    uint16_t noise = 0xACE1;
+    for (uint32_t ms = 0; ms < BENCH_SYNTHETIC_MS; ms++)
+    {
+        noise ^= noise << 7;
+        noise ^= noise >> 9;
+        noise ^= noise << 8;
+
+        int16_t level = SENSORS_BASELINE_INITIAL + ((noise & 0x0F) == 0 ? 1 : 0);
+        if (ms >= 3000 && ms < 4000)
+        {
+            level += 6; // Light blow - above the shipped 1-count strong threshold, starts a song
+        }
+        if ((ms >= 8000 && ms < 8400) || (ms >= 14000 && ms < 14300))
+        {
+            level += 120 + (noise & 0x1F); // Strong blow
+        }
+        samples->push_back((uint16_t)level);
+    }
+}
+
+static bool bench_load_trace(const char *path, std::vector<uint16_t> *samples)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "cannot read %s\n", path);
+        return false;
+    }
+
+    char line[64];
+    while (fgets(line, sizeof(line), file))
+    {
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+        samples->push_back((uint16_t)strtoul(line, NULL, 10));
+    }
+    fclose(file);
+    return !samples->empty();
+}
+
+// Returns false when the synthetic trace did not trigger the expected songs
+static bool bench_breath(const std::vector<uint16_t> &samples, bool synthetic)
+{
+    mock_reset();
+    lighting_init();
+    audio_init();
+    sensors_init();
+
+    FILE *trace = bench_open_trace("breath.csv", "ms,sample,baseline,intensity,song_playing");
+
+    uint64_t update_ns = 0;
+    uint32_t updates = 0;
+    uint32_t songs = 0;
+    uint32_t stops = 0;
+    uint32_t short_songs = 0;
+    uint32_t song_start_ms = 0;
+    bool was_playing = false;
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        // One queued sample per millisecond, as the ADC ISR delivers them
+        mock_microphone_push(samples[i]);
+        mock_advance_ms(1);
+        audio_update();
+
+        if ((i + 1) % SENSOR_UPDATE_RATE_MS == 0)
+        {
+            bench_clock_t::time_point start = bench_clock_t::now();
+            sensors_update();
+            update_ns += bench_ns_since(start);
+            updates++;
+        }
+
+        bool playing = audio_is_song_playing();
+        if (playing && !was_playing)
+        {
+            songs++;
+            song_start_ms = hardware_get_millis();
+        }
+        else if (!playing && was_playing)
+        {
+            stops++;
+            if (hardware_get_millis() - song_start_ms < BENCH_MIN_SONG_MS)
+            {
+                short_songs++;
+            }
+        }
+        was_playing = playing;
+
+        if (trace)
+        {
+            fprintf(trace, "%u,%u,%u,%u,%u\n", (unsigned)hardware_get_millis(), samples[i],
+                    sensors_get_mean_value(), sensors_get_breath_intensity(), playing ? 1 : 0);
+        }
+    }
+
+    bench_report("breath update (sensors_update)", update_ns, updates);
+    bench_report("breath per sample", update_ns, (uint32_t)samples.size());
+    printf("breath trace: %u samples, %u song trigger(s), %u stopped, %u shorter than %u ms\n", (unsigned)samples.size(),
+           (unsigned)songs, (unsigned)stops, (unsigned)short_songs, BENCH_MIN_SONG_MS);
+
+    if (trace)
+    {
+        fclose(trace);
+    }
+
+    if (synthetic && (songs != BENCH_SYNTHETIC_SONGS || stops != BENCH_SYNTHETIC_STOPS || short_songs != 0))
+    {
+        fprintf(stderr, "breath trace: expected %u song(s) and %u stop(s), none shorter than %u ms\n",
+                BENCH_SYNTHETIC_SONGS, BENCH_SYNTHETIC_STOPS, BENCH_MIN_SONG_MS);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char **argv)
+{
+    const char *adc_trace = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            g_trace_dir = argv[++i];
+        }
+        else
+        {
+            adc_trace = argv[i];
+        }
+    }
+
+    std::vector<uint16_t> samples;
+    if (adc_trace)
+    {
+        if (!bench_load_trace(adc_trace, &samples))
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        bench_synthetic_trace(&samples);
+    }
+
+    bench_candle();
+    bench_melodies();
+    bool checks_ok = bench_breath(samples, adc_trace == NULL);
+#if FEATURE_AUDIO_DDS
+    checks_ok = bench_harmony() && checks_ok;
+#endif
+
+    printf("%-40s %12s %10s\n", "benchmark", "ops", "ns/op");
+    for (size_t i = 0; i < g_results.size(); i++)
+    {
+        const bench_result_t &result = g_results[i];
+        printf("%-40s %12u %10.1f\n", result.name, (unsigned)result.ops,
+               result.ops ? (double)result.ns / result.ops : 0.0);
+    }
+    return checks_ok ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+/*
+ * avr/interrupt.h - Host stand-in for the native benchmark build
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#ifndef MOCK_AVR_INTERRUPT_H_
+#define MOCK_AVR_INTERRUPT_H_
+
+static inline void sei(void) {}
+static inline void cli(void) {}
+
+#endif // MOCK_AVR_INTERRUPT_H_
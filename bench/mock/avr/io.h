@@ -0,0 +1,37 @@
+/*
+ * avr/io.h - Host stand-in for the native benchmark build
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ *
+ * Only what the hardware.h API and the libraries above it touch: registers are plain variables
+ */
+
+#ifndef MOCK_AVR_IO_H_
+#define MOCK_AVR_IO_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    extern volatile uint8_t PORTB;
+    extern volatile uint8_t DDRB;
+    extern volatile uint8_t PINB;
+    extern volatile uint16_t ADC;
+
+#ifdef __cplusplus
+}
+#endif
+
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+
+#endif // MOCK_AVR_IO_H_
@@ -0,0 +1,25 @@
+/*
+ * avr/pgmspace.h - Host stand-in for the native benchmark build
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ *
+ * Flash and RAM share one address space on the host - PROGMEM reads are plain loads
+ */
+
+#ifndef MOCK_AVR_PGMSPACE_H_
+#define MOCK_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr) (*(void *const *)(addr))
+#define memcpy_P memcpy
+
+#endif // MOCK_AVR_PGMSPACE_H_
@@ -0,0 +1,224 @@
+/*
+ * hardware_mock.cpp - Host implementation of the hardware.h API for benchmarks
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ *
+ * Replaces lib/Hardware in the native env: time moves only when the benchmark says so
+ */
+
+#include "hardware_mock.h"
+#include <string.h>
+
+// ============================================================================
+// MOCK REGISTERS
+// ============================================================================
+
+volatile uint8_t PORTB;
+volatile uint8_t DDRB;
+volatile uint8_t PINB;
+volatile uint16_t ADC;
+
+// ============================================================================
+// MOCK STATE
+// ============================================================================
+
+uint8_t mock_led_brightness[LED_COUNT_MAX];
+uint16_t mock_audio_frequency;
+uint32_t mock_audio_notes;
+#if FEATURE_AUDIO_DDS
+uint32_t mock_dds_notes[AUDIO_DDS_VOICES];
+uint32_t mock_dds_note_ms[AUDIO_DDS_VOICES];
+uint16_t mock_dds_step[AUDIO_DDS_VOICES];
+#endif
+
+static uint32_t g_mock_millis;
+static uint8_t g_mock_eeprom[512];
+
+static uint16_t g_mock_mic_ring[MIC_ADC_RING_SIZE];
+static uint8_t g_mock_mic_head;
+static uint8_t g_mock_mic_tail;
+static uint16_t g_mock_mic_latest;
+
+// ============================================================================
+// MOCK CONTROL
+// ============================================================================
+
+void mock_reset(void)
+{
+    memset(mock_led_brightness, 0, sizeof(mock_led_brightness));
+    mock_audio_frequency = 0;
+    mock_audio_notes = 0;
+#if FEATURE_AUDIO_DDS
+    memset(mock_dds_notes, 0, sizeof(mock_dds_notes));
+    memset(mock_dds_note_ms, 0, sizeof(mock_dds_note_ms));
+    memset(mock_dds_step, 0, sizeof(mock_dds_step));
+#endif
+    g_mock_millis = 0;
+    memset(g_mock_eeprom, 0xFF, sizeof(g_mock_eeprom)); // Erased EEPROM
+    g_mock_mic_head = 0;
+    g_mock_mic_tail = 0;
+    g_mock_mic_latest = 0;
+}
+
+void mock_advance_ms(uint32_t ms)
+{
+    g_mock_millis += ms;
+}
+
+bool mock_microphone_push(uint16_t sample)
+{
+    uint8_t next = (g_mock_mic_head + 1) & (MIC_ADC_RING_SIZE - 1);
+    if (next == g_mock_mic_tail)
+    {
+        return false;
+    }
+    g_mock_mic_ring[g_mock_mic_head] = sample;
+    g_mock_mic_head = next;
+    g_mock_mic_latest = sample;
+    ADC = sample;
+    return true;
+}
+
+// ============================================================================
+// hardware.h API
+// ============================================================================
+
+void hardware_init(void)
+{
+    mock_reset();
+}
+
+void hardware_led_set(led_id_t led, uint8_t brightness)
+{
+    if (led < LED_COUNT_MAX)
+    {
+        mock_led_brightness[led] = brightness;
+    }
+}
+
+void hardware_led_commit(const uint8_t frame[LED_COUNT_MAX])
+{
+    memcpy(mock_led_brightness, frame, sizeof(mock_led_brightness));
+}
+
+void hardware_led_all_off(void)
+{
+    memset(mock_led_brightness, 0, sizeof(mock_led_brightness));
+}
+
+void hardware_init_pwm(void)
+{
+}
+
+uint32_t hardware_get_millis(void)
+{
+    return g_mock_millis;
+}
+
+uint16_t hardware_get_ticks(void)
+{
+    return (uint16_t)g_mock_millis;
+}
+
+uint8_t hardware_get_ticks8(void)
+{
+    return (uint8_t)g_mock_millis;
+}
+
+void hardware_idle(void)
+{
+    g_mock_millis++; // The next interrupt on the chip is at most a millis tick away
+}
+
+#if STANDBY_TIMEOUT_S > 0 && FEATURE_MICROPHONE_SENSOR
+void hardware_standby(uint16_t wake_level)
+{
+    (void)wake_level;
+}
+#endif
+
+void hardware_microphone_init(void)
+{
+}
+
+bool hardware_microphone_pop(uint16_t *sample)
+{
+    if (g_mock_mic_tail == g_mock_mic_head)
+    {
+        return false;
+    }
+    *sample = g_mock_mic_ring[g_mock_mic_tail];
+    g_mock_mic_tail = (g_mock_mic_tail + 1) & (MIC_ADC_RING_SIZE - 1);
+    return true;
+}
+
+uint16_t hardware_microphone_read(void)
+{
+    return g_mock_mic_latest;
+}
+
+#if FEATURE_MIC_ADC_NOISE_REDUCTION
+bool hardware_microphone_sample_quiet(uint16_t *sample)
+{
+    return hardware_microphone_pop(sample);
+}
+#endif
+
+void hardware_audio_init(void)
+{
+    mock_audio_frequency = 0;
+}
+
+void hardware_audio_set_timer(uint8_t clock_select, uint8_t top, uint8_t compare)
+{
+    (void)compare;
+    mock_audio_frequency = clock_select ? (uint16_t)((F_CPU >> (clock_select - 1)) / (top + 1u)) : 0; // Back to Hz for the traces
+    mock_audio_notes++;
+}
+
+void hardware_audio_stop(void)
+{
+    mock_audio_frequency = 0;
+}
+
+#if FEATURE_AUDIO_DDS
+void hardware_audio_dds_start(uint8_t duty_scale, uint8_t voices)
+{
+    (void)duty_scale;
+    (void)voices;
+    mock_audio_frequency = 0;
+}
+
+void hardware_audio_dds_voice(uint8_t voice, uint16_t phase_step)
+{
+    if (phase_step && voice < AUDIO_DDS_VOICES)
+    {
+        mock_dds_notes[voice]++;
+        mock_dds_note_ms[voice] = g_mock_millis;
+        mock_dds_step[voice] = phase_step;
+    }
+    if (voice == 0) // Melody voice, back to Hz for the traces
+    {
+        mock_audio_frequency = (uint16_t)(((uint32_t)phase_step * AUDIO_DDS_SAMPLE_RATE + 32768) >> 16);
+        mock_audio_notes += phase_step ? 1 : 0;
+    }
+}
+#endif
+
+uint8_t hardware_eeprom_read_byte(uint16_t address)
+{
+    return g_mock_eeprom[address % sizeof(g_mock_eeprom)];
+}
+
+void hardware_eeprom_write_byte(uint16_t address, uint8_t data)
+{
+    g_mock_eeprom[address % sizeof(g_mock_eeprom)] = data;
+}
+
+bool hardware_eeprom_write_queued(uint16_t address, uint8_t data)
+{
+    hardware_eeprom_write_byte(address, data); // No write time on the host
+    return true;
+}
@@ -0,0 +1,46 @@
+/*
+ * hardware_mock.h - Host implementation of the hardware.h API for benchmarks
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#ifndef HARDWARE_MOCK_H_
+#define HARDWARE_MOCK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../lib/Hardware/hardware.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // MOCK CONTROL - what the ISRs and peripherals would do on the chip
+    // ============================================================================
+
+    void mock_reset(void);
+    void mock_advance_ms(uint32_t ms);         // Let time pass (hardware_idle() also advances 1ms)
+    bool mock_microphone_push(uint16_t sample); // Queue a sample as the ADC ISR would (false = ring full)
+
+    // ============================================================================
+    // MOCK INSPECTION
+    // ============================================================================
+
+    extern uint8_t mock_led_brightness[LED_COUNT_MAX]; // Last hardware_led_set()/hardware_led_commit() per ring
+    extern uint16_t mock_audio_frequency;              // Tone playing (0 = silent)
+    extern uint32_t mock_audio_notes;                  // hardware_audio_set_timer() calls since mock_reset()
+#if FEATURE_AUDIO_DDS
+    extern uint32_t mock_dds_notes[AUDIO_DDS_VOICES];   // Notes started per DDS voice since mock_reset()
+    extern uint32_t mock_dds_note_ms[AUDIO_DDS_VOICES]; // hardware_get_millis() of the last one
+    extern uint16_t mock_dds_step[AUDIO_DDS_VOICES];    // ...and its phase step
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HARDWARE_MOCK_H_
@@ -0,0 +1,15 @@
+/*
+ * util/delay.h - Host stand-in for the native benchmark build
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#ifndef MOCK_UTIL_DELAY_H_
+#define MOCK_UTIL_DELAY_H_
+
+static inline void _delay_us(double us) { (void)us; }
+static inline void _delay_ms(double ms) { (void)ms; }
+
+#endif // MOCK_UTIL_DELAY_H_
@@ -30,20 +30,32 @@
 // ============================================================================
 
 
-// Lighting Effects - chose ONE !!!
-#define FEATURE_CANDLE_EFFECT 1       // Flickering candle simulation - ACTIVE
-#define FEATURE_BREATHING_EFFECT 0    // Smooth breathing animation - Available but disabled
-#define FEATURE_CANDLE_EFFECT_KRANZ 0 // Flickering candle simulation (Kranz) - Available but disabled
+// Lighting Effects - FEATURE_CANDLE_EFFECT, FEATURE_BREATHING_EFFECT, FEATURE_ADC_TEST_EFFECT
+// and LIGHTING_EFFECT_DEFAULT come from the config.yaml lighting section (hardware_config_generated.h)
+
+// LED PWM Engine
+#define FEATURE_LED_HW_PWM 0 // Timer0 fast PWM drives LED_1ER/LED_5ER on OC0A/OC0B, millis from overflow (0 = all rings software PWM)
+#define FEATURE_LED_BAM_PWM 0 // Bit-angle modulation for the software PWM rings: 8 weighted slices per frame (not with FEATURE_LED_HW_PWM)
 
 // Sensor Support
 #define FEATURE_MICROPHONE_SENSOR 1 // Breath detection via microphone (enabled for testing)
+#define FEATURE_MIC_ADC_NOISE_REDUCTION 0 // One conversion per sensor update in SLEEP_MODE_ADC (stalls Timer0/Timer1 ~110us each)
 
 // Audio System 
 #define FEATURE_AUDIO_OUTPUT 1   // Full-featured buzzer/speaker support
+#ifndef FEATURE_AUDIO_DDS
+#define FEATURE_AUDIO_DDS 0      // Two-voice DDS on Timer1 (melody + harmony staff, sample ISR at 31.25kHz while a song plays)
+#endif
 
 // Advanced Features
 #define FEATURE_EEPROM_SETTINGS 1     // Persistent settings storage
 #define FEATURE_MEMORY_OPTIMIZATION 1 // Aggressive size optimization
+#ifndef FEATURE_PROFILING
+#define FEATURE_PROFILING 0           // PROF_BEGIN/PROF_END cycle counters dumped to EEPROM (debug builds, attiny85_profile env)
+#endif
+#ifndef FEATURE_TELEMETRY
+#define FEATURE_TELEMETRY 0           // Soft-UART detector/loop telemetry on PB2 instead of LED_4ER (debug builds, attiny85_telemetry env)
+#endif
 
 // ============================================================================
 // PIN ASSIGNMENTS (ATtiny85)
@@ -96,6 +108,72 @@
 #define IS_DEBUG_BUILD 1
 #endif
 
+// Profiling probes are a debug-build instrument - compiled out of production builds
+#if FEATURE_PROFILING && IS_DEBUG_BUILD
+#define PROF_ENABLED 1
+#else
+#define PROF_ENABLED 0
+#endif
+#define PROF_DUMP_MS 10000 // Profile table written to EEPROM this often (blocks ~3.4ms per changed byte)
+#define PROF_EEPROM_MAGIC 0x50 // 'P' - marks a valid dump for scripts/read_profile.py
+
+// Telemetry: TX-only soft UART on the ISP SCK pin, one bit per software PWM step (8N1, HARDWARE_TELEMETRY_BAUD)
+// Frames of raw ADC samples, baseline/envelope, trigger events and loop load for scripts/read_telemetry.py
+#if FEATURE_TELEMETRY && IS_DEBUG_BUILD
+#define TELEM_ENABLED 1
+#else
+#define TELEM_ENABLED 0
+#endif
+#define PIN_TELEMETRY_TX ISP_PIN_SCK  // PB2 - LED_4ER stays dark, its driver follows the TX line
+#define TELEMETRY_FRAME_MS 20         // One frame per scheduler period (~39 bytes with 20 samples, ~78% of 25000 baud)
+#define TELEMETRY_MAX_SAMPLES 24      // ADC samples per frame (1kHz), more set TELEMETRY_EVENT_SAMPLES_LOST
+#define TELEMETRY_TX_BUFFER_SIZE 64   // Soft-UART queue in bytes, power of two (a frame that does not fit is dropped)
+#define TELEMETRY_SYNC 0xA5           // First byte of every frame
+
+// simavr timing run (attiny85_sim env, CI simulation job): plays every song once, then halts
+// LED pins, Timer1 and the GPIOR0-2 markers are traced to a VCD for scripts/vcd_report.py
+#ifndef SIMULATION_MODE
+#define SIMULATION_MODE 0 // 1 = song sequence + trace markers, never flashed to a kit
+#endif
+#define SIMULATION_CHECK_MS 10 // Song-finished poll period (scheduler task)
+
+// ============================================================================
+// POWER MANAGEMENT
+// ============================================================================
+
+// Current-draw measurement builds (attiny85_power / attiny85_power_busy envs in platformio.ini)
+#ifndef POWER_MEASUREMENT_MODE
+#define POWER_MEASUREMENT_MODE 0      // 1 = fixed LED level, no effects or songs - stable reading on a series ammeter
+#endif
+#ifndef POWER_MEASUREMENT_BUSY_LOOP
+#define POWER_MEASUREMENT_BUSY_LOOP 0 // 1 = former _delay_us(10) busy loop instead of idle sleep (A/B reference)
+#endif
+#define POWER_MEASUREMENT_BRIGHTNESS 0 // LED level held in measurement mode (0 = MCU current only)
+
+// Standby: power-down after STANDBY_TIMEOUT_S without breath, songs or cooldown (config.yaml standby_timeout)
+// The watchdog wakes the CPU every STANDBY_SNIFF_MS for a microphone sniff; a sniff STANDBY_WAKE_MARGIN
+// above the baseline resumes the candle effect, and unless sensors_update() confirms a breath within
+// STANDBY_WAKE_GRACE_MS the tree powers down again. Wake latency: <= STANDBY_SNIFF_MS (WDT oscillator, +/-10%)
+// plus ~0.7ms for the sniff conversions and the Timer0/ADC restart - ~65ms on average.
+#ifndef STANDBY_TIMEOUT_S
+#define STANDBY_TIMEOUT_S 1800 // Seconds of inactivity before standby (0 = never)
+#endif
+#define STANDBY_SNIFF_MS 125                               // Watchdog period in power-down
+#define STANDBY_WDT_PRESCALER ((1 << WDP1) | (1 << WDP0)) // WDT prescaler for STANDBY_SNIFF_MS (16K cycles)
+#define STANDBY_SNIFF_SAMPLES 4                            // Conversions averaged per sniff
+#define STANDBY_CHECK_MS 250                               // Inactivity check period (scheduler task)
+#define STANDBY_WAKE_MARGIN 16                             // Sniff level above the baseline that wakes (ADC counts, a blow lifts ~100)
+#define STANDBY_WAKE_GRACE_MS 10000                        // Awake time after a wake without a confirmed breath
+
+// ============================================================================
+// TASK SCHEDULING
+// ============================================================================
+
+// Main-loop tasks run from a PROGMEM table (lib/Scheduler), see main.cpp for the periods
+#define SCHEDULER_MAX_TASKS 8                // Table entries with deadline/overrun state in RAM
+#define LIGHTING_FRAME_MS CANDLE_FLICKER_SPEED // lighting_update() period of the candle - one flicker keyframe
+#define LIGHTING_SLEW_MS 1                     // lighting_interpolate() period - candle slew toward the frame's keyframe
+
 // ============================================================================
 // DEFAULT CONFIGURATION - Fallback values if not overridden by generated config
 // ============================================================================
@@ -107,6 +185,20 @@
 #endif
 #define LED_BRIGHTNESS_MIN 10     // Minimum brightness (not configurable via YAML)
 
+// Lighting Effects - Fallback values (candle only)
+#ifndef FEATURE_CANDLE_EFFECT
+#define FEATURE_CANDLE_EFFECT 1
+#endif
+#ifndef FEATURE_BREATHING_EFFECT
+#define FEATURE_BREATHING_EFFECT 0
+#endif
+#ifndef FEATURE_ADC_TEST_EFFECT
+#define FEATURE_ADC_TEST_EFFECT 0
+#endif
+#ifndef LIGHTING_EFFECT_DEFAULT
+#define LIGHTING_EFFECT_DEFAULT LIGHTING_EFFECT_CANDLE
+#endif
+
 // Audio System Configuration - Fallback values
 #ifndef AUDIO_MAX_FREQUENCY
 #define AUDIO_MAX_FREQUENCY 4000 // Hz
@@ -153,7 +245,19 @@
 // ============================================================================
 
 // EEPROM Storage Addresses
-#define EEPROM_ADDR_SONG_ROTATION_INDEX 0x00 // Persistent song rotation index (1 byte)
+#define EEPROM_ADDR_SONG_ROTATION 0x00 // Song rotation index ring, 2 bytes per slot (index, sequence)
+#define EEPROM_ADDR_PROFILE 0x40       // FEATURE_PROFILING dump (4-byte header + 10 bytes per probe)
+
+// Wear leveling: each save moves to the next slot, the newest slot is found by its sequence at boot
+#ifndef EEPROM_SONG_ROTATION_SLOTS
+#define EEPROM_SONG_ROTATION_SLOTS 16 // 2-255 slots, each cell gets 1/16 of the per-song writes
+#endif
+#define EEPROM_WRITE_QUEUE_SIZE 4     // Bytes waiting for the EE_READY interrupt (one save = 2 bytes)
+
+#if EEPROM_SONG_ROTATION_SLOTS < 2 || EEPROM_SONG_ROTATION_SLOTS > 255 || \
+    EEPROM_ADDR_SONG_ROTATION + 2 * EEPROM_SONG_ROTATION_SLOTS > EEPROM_ADDR_PROFILE
+#error "EEPROM_SONG_ROTATION_SLOTS: 2-255 slots that end below EEPROM_ADDR_PROFILE"
+#endif
 
 // ============================================================================
 // SENSOR SYSTEM CONFIGURATION - Fallback values
@@ -161,13 +265,21 @@
 
 // PWM-Based Microphone Sampling for PB3 (LED_3ER + Microphone sharing in DEBUG builds)
 // Samples microphone during natural LOW periods of LED_3ER's PWM cycle
-// This allows very frequent sampling (potentially hundreds of times per second) without visible LED impact
-#define MIC_SAMPLE_INTERVAL_MIN 1     // Sample every Nth PWM cycle during LOW periods (higher = less frequent sampling)
+// The PWM engine opens the sampling window at LED_3ER's off edge and closes it at the next frame start
 
 #ifndef SENSOR_UPDATE_RATE_MS
 #define SENSOR_UPDATE_RATE_MS 5  // How often sensors_update() reads microphone (lower = more responsive, 1-50ms recommended)
 #endif
 
+// Interrupt-driven ADC: auto-triggered by the Timer0 PWM step while the sampling window is open
+// ~8kHz conversions (prescaler 64), averaged in the ADC ISR and queued for sensors_update()
+#define MIC_ADC_OVERSAMPLE_SHIFT 3 // 2^3 = 8 conversions per queued sample (~1kHz sample rate)
+#define MIC_ADC_RING_SIZE 8        // Queued samples (power of two) - covers > SENSOR_UPDATE_RATE_MS
+
+// ADC noise reduction mode (FEATURE_MIC_ADC_NOISE_REDUCTION): the CPU and clkIO stop for the conversion,
+// Timer0 pauses with them - millis is credited the stalled time afterwards
+#define MIC_ADC_NR_STALL_US 110    // 13 ADC clocks at 125kHz + wake-up
+
 // Breath Detection Thresholds - Fallback values
 // Lower values = more sensitive, higher values = less sensitive
 // Note: Baseline is now dynamically calibrated, only thresholds are static
@@ -178,6 +290,8 @@
 #define BREATH_LIGHT_THRESHOLD 1       // Light breath threshold for LED response
 #define BREATH_STRONG_THRESHOLD 1     // Strong breath threshold for audio trigger (lower = more sensitive)
 #define BREATH_STRONG_MIN_DURATION 2   // Number of consecutive readings above strong threshold (very fast sampling = 1 is enough)
+#define BREATH_STOP_MIN_DURATION 8     // Consecutive strong readings needed to stop a playing song (longer - buzzer is active)
+#define BREATH_LONG_BLOW_MS 1500       // A strong blow held this long switches to the next lighting effect
 
 #ifndef SONG_COOLDOWN_MS
 #define SONG_COOLDOWN_MS 3000    // Cooldown period (ms) after song ends - prevents rapid re-triggering
@@ -209,12 +323,12 @@
 // LED_4ER (Middle):     Mid notes F4 to G4 (F4, FS4, G4)
 // LED_5ER (Base/Bottom): Low notes E4 and below (E4 and lower)
 //
-#define AUDIO_NOTE_LED_1ER_MIN NOTE_C5  // LED_1ER (tip): C5 (344 Hz) and above - highest notes (C5, D5+)
-#define AUDIO_NOTE_LED_3ER_MIN NOTE_GS4 // LED_3ER (upper): GS4 (273 Hz) to B4 (326 Hz) - high-mid notes (GS4, A4, AS4, B4)
+#define AUDIO_NOTE_LED_1ER_MIN NOTE_C5  // LED_1ER (tip): C5 (523 Hz) and above - highest notes (C5, D5+)
+#define AUDIO_NOTE_LED_3ER_MIN NOTE_GS4 // LED_3ER (upper): GS4 (415 Hz) to B4 (494 Hz) - high-mid notes (GS4, A4, AS4, B4)
 #define AUDIO_NOTE_LED_3ER_MAX NOTE_B4
-#define AUDIO_NOTE_LED_4ER_MIN NOTE_F4  // LED_4ER (middle): F4 (229 Hz) to G4 (257 Hz) - mid notes (F4, FS4, G4)
+#define AUDIO_NOTE_LED_4ER_MIN NOTE_F4  // LED_4ER (middle): F4 (349 Hz) to G4 (392 Hz) - mid notes (F4, FS4, G4)
 #define AUDIO_NOTE_LED_4ER_MAX NOTE_G4
-#define AUDIO_NOTE_LED_5ER_MAX NOTE_E4  // LED_5ER (base): E4 (216 Hz) and below - bass notes (E4 and lower)
+#define AUDIO_NOTE_LED_5ER_MAX NOTE_E4  // LED_5ER (base): E4 (330 Hz) and below - bass notes (E4 and lower)
 
 // Candle Flicker Configuration - Fallback values
 #ifndef CANDLE_FLICKER_SPEED
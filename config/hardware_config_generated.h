@@ -33,4 +33,13 @@
 #define AUDIO_NOTE_GAP_MS 50
 #define STARTUP_MELODY_ENABLED false
 
+// Power Management
+#define STANDBY_TIMEOUT_S 1800
+
+// Lighting Effects (a long blow cycles through the enabled ones)
+#define FEATURE_CANDLE_EFFECT 1
+#define FEATURE_BREATHING_EFFECT 1
+#define FEATURE_ADC_TEST_EFFECT 0
+#define LIGHTING_EFFECT_DEFAULT LIGHTING_EFFECT_CANDLE
+
 #endif // HARDWARE_CONFIG_GENERATED_H_
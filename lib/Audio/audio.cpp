@@ -15,35 +15,59 @@
 #if FEATURE_AUDIO_OUTPUT
 
 #include "../Hardware/hardware.h"
-#if FEATURE_MICROPHONE_SENSOR
-#include "../Sensors/sensors.h"
-#endif
 #include "../Lighting/lighting.h"
 #include <avr/pgmspace.h>
-#include <util/delay.h>
 
 // ============================================================================
 // PRIVATE VARIABLES
 // ============================================================================
 
+// Sequencer phases for the non-blocking player
+typedef enum
+{
+    AUDIO_PHASE_IDLE = 0, // No song playing
+    AUDIO_PHASE_NOTE,     // Tone (or rest) of the current note is sounding
+    AUDIO_PHASE_GAP       // Silence between the current and the next note
+} audio_phase_t;
+
+// Read position in a packed note stream
+typedef struct
+{
+    const uint8_t *cursor;        // Next packed note in PROGMEM
+    const uint8_t *return_cursor; // Stream position after the shared segment being played (NULL = none)
+} audio_stream_t;
+
 typedef struct
 {
     bool initialized;
     uint8_t song_rotation_index; // Current song in rotation for persistent state
+    uint8_t rotation_slot;       // EEPROM ring slot holding song_rotation_index
+    uint8_t rotation_sequence;   // Sequence byte of that slot
     bool song_currently_playing; // Track if a song is currently being played
     uint32_t song_end_time;      // When the current song finished
     uint32_t cooldown_end_time;  // When the cooldown period ends (song_end_time + SONG_COOLDOWN_DURATION)
+    bool cooldown_active;        // cooldown_end_time not reached yet (skips the millis read once expired)
+
+    // Non-blocking sequencer state (stepped by audio_update)
+    audio_song_t song;           // RAM copy of the playing song's PROGMEM descriptor
+    audio_stream_t melody;
+    uint8_t note_index;          // Note currently sounding (or followed by the current gap)
+    audio_phase_t phase;
+    uint16_t phase_start_time;   // hardware_get_ticks() when the current phase started
+    uint16_t phase_duration_ms;  // Length of the current phase
+
+#if FEATURE_AUDIO_DDS
+    // Second DDS voice, stepped on its own timeline next to the melody
+    audio_stream_t harmony;
+    uint8_t harmony_notes_left;  // Including the one sounding
+    audio_phase_t harmony_phase; // AUDIO_PHASE_IDLE once the harmony stream is done
+    uint16_t harmony_start_time;
+    uint16_t harmony_duration_ms;
+#endif
 } audio_state_t;
 
 static audio_state_t g_audio_state;
 
-// ============================================================================
-// SONG COMPILER SELECTION 
-//============================================================================
-
-// Forward declaration for blocking bit-banging helper
-static void audio_play_tone_blocking_configurable(uint16_t frequency, uint16_t duration_ms, uint8_t duty_cycle_percent);
-
 // Note: enabled_songs[] and ENABLED_SONG_COUNT are now provided by audio_songs_generated.cpp
 
 // ============================================================================
@@ -51,90 +75,186 @@ static void audio_play_tone_blocking_configurable(uint16_t frequency, uint16_t d
 // ============================================================================
 
 
-// Transpose a frequency by semitones (positive = up, negative = down)
-// Uses fixed-point arithmetic to avoid floating point operations
-// Formula: new_freq = old_freq * 2^(semitones/12)
-static uint16_t transpose_frequency(uint16_t frequency, int8_t semitones)
+// Note frequency lookup table, indexed by packed pitch index
+// Only drives the audio-reactive lighting - the tone is set from audio_pitch_timers[]
+static const uint16_t PROGMEM audio_pitch_frequencies[AUDIO_PITCH_COUNT] = {
+    NOTE_G3,  // 0
+    NOTE_GS3, // 1
+    NOTE_A3,  // 2
+    NOTE_AS3, // 3
+    NOTE_B3,  // 4
+    NOTE_C4,  // 5
+    NOTE_CS4, // 6
+    NOTE_D4,  // 7
+    NOTE_DS4, // 8
+    NOTE_E4,  // 9
+    NOTE_F4,  // 10
+    NOTE_FS4, // 11
+    NOTE_G4,  // 12
+    NOTE_GS4, // 13
+    NOTE_A4,  // 14
+    NOTE_AS4, // 15
+    NOTE_B4,  // 16
+    NOTE_C5,  // 17
+    NOTE_CS5, // 18
+    NOTE_D5,  // 19
+    NOTE_DS5, // 20
+    NOTE_E5,  // 21
+    NOTE_F5,  // 22
+    NOTE_FS5, // 23
+    NOTE_G5,  // 24
+    NOTE_GS5, // 25
+    NOTE_A5,  // 26
+    NOTE_AS5, // 27
+    NOTE_B5,  // 28
+    NOTE_C6,  // 29
+    NOTE_CS6, // 30
+    NOTE_D6,  // 31
+    NOTE_DS6, // 32
+    NOTE_E6,  // 33
+    NOTE_F6,  // 34
+    NOTE_FS6, // 35
+    NOTE_G6,  // 36
+    NOTE_GS6, // 37
+    NOTE_A6,  // 38
+    NOTE_AS6  // 39
+};
+
+#if FEATURE_AUDIO_DDS
+// Phase step of a pitch index, 0 (silent voice) for rests
+static uint16_t audio_pitch_dds_step(uint8_t pitch)
+{
+    return (pitch < AUDIO_PITCH_COUNT) ? pgm_read_word(&audio_pitch_dds_steps[pitch]) : 0;
+}
+
+// Both voices carve the gap out of the note, so they stay on the notated timeline together
+static uint16_t audio_sounding_ms(uint16_t duration_ms)
+{
+    uint8_t gap_ms = g_audio_state.song.gap_ms;
+    return (duration_ms > gap_ms) ? duration_ms - gap_ms : 1;
+}
+#else
+// Timer1 tone of a pitch index: two table bytes and the duty compare, Timer1 stopped for rests
+static void audio_play_pitch(uint8_t pitch)
 {
-    if (semitones == 0 || frequency == 0)
+    if (pitch >= AUDIO_PITCH_COUNT)
     {
-        return frequency; // No transposition or rest note
+        hardware_audio_set_timer(0, 0, 0);
+        return;
     }
 
-    // Note frequency lookup table - uses actual frequencies from audio.h
-    // This ensures transposition uses the fine-tuned buzzer frequencies
-    static const uint16_t PROGMEM note_frequencies[] = {
-        NOTE_G3,  // 0
-        NOTE_GS3, // 1
-        NOTE_A3,  // 2
-        NOTE_AS3, // 3
-        NOTE_B3,  // 4
-        NOTE_C4,  // 5
-        NOTE_CS4, // 6
-        NOTE_D4,  // 7
-        NOTE_DS4, // 8
-        NOTE_E4,  // 9
-        NOTE_F4,  // 10
-        NOTE_FS4, // 11
-        NOTE_G4,  // 12
-        NOTE_GS4, // 13
-        NOTE_A4,  // 14
-        NOTE_AS4, // 15
-        NOTE_B4,  // 16
-        NOTE_C5,  // 17
-        NOTE_CS5, // 18
-        NOTE_D5,  // 19
-        NOTE_DS5, // 20
-        NOTE_E5,  // 21
-        NOTE_F5,  // 22
-        NOTE_FS5, // 23
-        NOTE_G5,  // 24
-        NOTE_GS5, // 25
-        NOTE_A5,  // 26
-        NOTE_AS5, // 27
-        NOTE_B5,  // 28
-        NOTE_C6,  // 29
-        NOTE_CS6, // 30
-        NOTE_D6,  // 31
-        NOTE_DS6, // 32
-        NOTE_E6   // 33
-    };
-    
-    const uint8_t note_count = sizeof(note_frequencies) / sizeof(uint16_t);
+    uint8_t clock_select = pgm_read_byte(&audio_pitch_timers[pitch].clock_select);
+    uint8_t top = pgm_read_byte(&audio_pitch_timers[pitch].top);
 
-    // Find closest matching note in the table
-    int8_t note_index = -1;
-    uint16_t min_diff = 65535;
-    
-    for (uint8_t i = 0; i < note_count; i++)
+    // High time as share of the period, kept below top so OC1B always toggles
+    uint8_t compare = (uint8_t)(((uint16_t)(top + 1) * g_audio_state.song.duty_scale) >> 8);
+    if (compare > top)
+        compare = top;
+    if (compare == 0)
+        compare = 1;
+
+    hardware_audio_set_timer(clock_select, top, compare);
+}
+#endif
+
+// Frequency of a pitch index shifted by semitones (clamped to the table), 0 for rests
+static uint16_t audio_pitch_frequency(uint8_t pitch, int8_t semitones)
+{
+    if (pitch >= AUDIO_PITCH_COUNT)
     {
-        uint16_t table_freq = pgm_read_word(&note_frequencies[i]);
-        uint16_t diff = (frequency > table_freq) ? (frequency - table_freq) : (table_freq - frequency);
-        
-        if (diff < min_diff)
-        {
-            min_diff = diff;
-            note_index = i;
-        }
+        return 0; // Rest
     }
 
-    // If no match found or out of bounds, use ratio-based fallback
-    if (note_index < 0)
+    int8_t index = (int8_t)pitch + semitones;
+    if (index < 0)
+        index = 0;
+    if (index >= AUDIO_PITCH_COUNT)
+        index = AUDIO_PITCH_COUNT - 1;
+
+    return pgm_read_word(&audio_pitch_frequencies[index]);
+}
+
+// Decode the next packed note and advance the cursor past it
+// Follows segment calls/returns, so the song and its shared phrases play as one stream
+// Returns the pitch index (AUDIO_PITCH_REST for rests), duration in ms via duration_ms
+static uint8_t audio_decode_note(audio_stream_t *stream, uint16_t *duration_ms)
+{
+    const uint8_t **cursor = &stream->cursor;
+    uint8_t code = pgm_read_byte((*cursor)++);
+
+    if (code == AUDIO_PITCH_RETURN)
     {
-        return frequency;
+        *cursor = stream->return_cursor;
+        stream->return_cursor = NULL;
+        code = pgm_read_byte((*cursor)++);
     }
 
-    // Apply transposition by shifting in the note table
-    int8_t transposed_index = note_index + semitones;
-    
-    // Clamp to valid range
-    if (transposed_index < 0)
-        transposed_index = 0;
-    if (transposed_index >= note_count)
-        transposed_index = note_count - 1;
+    if (code == AUDIO_PITCH_SEGMENT)
+    {
+        uint8_t segment = pgm_read_byte((*cursor)++);
+        stream->return_cursor = *cursor;
+        *cursor = audio_segment_notes + pgm_read_word(&audio_segment_offsets[segment]);
+        code = pgm_read_byte((*cursor)++);
+    }
+
+    uint8_t duration_code = code >> AUDIO_DURATION_SHIFT;
+    uint8_t ticks;
+
+    if (duration_code == AUDIO_DURATION_EXPLICIT)
+    {
+        ticks = pgm_read_byte((*cursor)++);
+    }
+    else
+    {
+        ticks = g_audio_state.song.duration_ticks[duration_code];
+    }
+
+    *duration_ms = ticks * g_audio_state.song.tick_ms;
+    return code & AUDIO_PITCH_MASK;
+}
+
+#if ENABLE_SONG_ROTATION
+// Rotation index ring at EEPROM_ADDR_SONG_ROTATION: slot = {index, sequence}, each save takes the
+// next slot with sequence + 1. The newest slot is the last one its successor does not continue
+// (erased EEPROM reads as slot 0, index 0xFF - rejected by the range check in audio_init)
+static void audio_rotation_load(void)
+{
+    uint8_t slot = 0;
+    uint8_t sequence = hardware_eeprom_read_byte(EEPROM_ADDR_SONG_ROTATION + 1);
+    for (uint8_t next = 1; next < EEPROM_SONG_ROTATION_SLOTS; next++)
+    {
+        uint8_t next_sequence = hardware_eeprom_read_byte(EEPROM_ADDR_SONG_ROTATION + 2 * next + 1);
+        if (next_sequence != (uint8_t)(sequence + 1))
+        {
+            break;
+        }
+        slot = next;
+        sequence = next_sequence;
+    }
+
+    g_audio_state.rotation_slot = slot;
+    g_audio_state.rotation_sequence = sequence;
+    g_audio_state.song_rotation_index = hardware_eeprom_read_byte(EEPROM_ADDR_SONG_ROTATION + 2 * slot);
+}
 
-    return pgm_read_word(&note_frequencies[transposed_index]);
+// Queue the rotation index into the next ring slot - the EE_READY ISR writes it in the background
+static void audio_rotation_save(void)
+{
+    uint8_t slot = g_audio_state.rotation_slot + 1;
+    if (slot >= EEPROM_SONG_ROTATION_SLOTS)
+        slot = 0;
+    uint16_t address = EEPROM_ADDR_SONG_ROTATION + 2 * slot;
+    uint8_t sequence = g_audio_state.rotation_sequence + 1;
+
+    // Index before sequence: a write cut short by power loss leaves the previous slot the newest
+    if (hardware_eeprom_write_queued(address, g_audio_state.song_rotation_index) &&
+        hardware_eeprom_write_queued(address + 1, sequence))
+    {
+        g_audio_state.rotation_slot = slot;
+        g_audio_state.rotation_sequence = sequence;
+    }
 }
+#endif
 
 // ============================================================================
 // PUBLIC FUNCTIONS
@@ -146,13 +266,12 @@ bool audio_init(void)
 
     // Load persistent song rotation index
 #if ENABLE_SONG_ROTATION
-    g_audio_state.song_rotation_index = hardware_eeprom_read_byte(EEPROM_ADDR_SONG_ROTATION_INDEX);
+    audio_rotation_load();
 
-    // Validate the index (in case EEPROM is uninitialized or corrupted)
+    // Validate the index (in case EEPROM is uninitialized or corrupted) - the next save repairs the ring
     if (ENABLED_SONG_COUNT > 0 && g_audio_state.song_rotation_index >= ENABLED_SONG_COUNT)
     {
         g_audio_state.song_rotation_index = 0;
-        hardware_eeprom_write_byte(EEPROM_ADDR_SONG_ROTATION_INDEX, 0);
     }
 #endif
 
@@ -160,151 +279,205 @@ bool audio_init(void)
     g_audio_state.song_currently_playing = false;
     g_audio_state.song_end_time = 0;
     g_audio_state.cooldown_end_time = 0;
+    g_audio_state.cooldown_active = false;
+
+    // Buzzer pin LOW, Timer1 tone engine idle
+    hardware_audio_init();
 
     g_audio_state.initialized = true;
     return true;
 }
 
-// Non-blocking functions removed - using blocking-only approach
+// Start sounding note_index: tone on Timer1, audio-reactive lighting, phase timing
+static void audio_start_note(uint16_t current_time)
+{
+    uint16_t duration_ms;
+    uint8_t pitch = audio_decode_note(&g_audio_state.melody, &duration_ms);
+
+    // Trigger audio-reactive lighting based on ORIGINAL note frequency (not transposed)
+    // This keeps the light show matched to the musical pitch relationships as written
+    lighting_audio_reactive_note(audio_pitch_frequency(pitch, -g_audio_state.song.transpose_semitones), duration_ms);
+
+#if FEATURE_AUDIO_DDS
+    hardware_audio_dds_voice(0, audio_pitch_dds_step(pitch));
+    duration_ms = audio_sounding_ms(duration_ms);
+#else
+    // Timer1 generates the tone, audio_update() only watches the clock
+    audio_play_pitch(pitch); // Already transposed by the generator
+#endif
+
+    g_audio_state.phase = AUDIO_PHASE_NOTE;
+    g_audio_state.phase_start_time = current_time;
+    g_audio_state.phase_duration_ms = duration_ms; // Speed is baked into tick_ms
+}
 
-void audio_play_melody_blocking(melody_id_t melody_id, uint8_t duty_cycle_percent, uint16_t speed_percent, int8_t transpose_semitones)
+#if FEATURE_AUDIO_DDS
+// Start the next harmony note on DDS voice 1
+static void audio_start_harmony_note(uint16_t current_time)
 {
-    uint8_t note_count = 0;
-    const audio_note_t *melody_data = get_melody_data(melody_id, &note_count);
-    
-    if (!melody_data || note_count == 0)
+    uint16_t duration_ms;
+    uint8_t pitch = audio_decode_note(&g_audio_state.harmony, &duration_ms);
+    hardware_audio_dds_voice(1, audio_pitch_dds_step(pitch));
+
+    g_audio_state.harmony_phase = AUDIO_PHASE_NOTE;
+    g_audio_state.harmony_start_time = current_time;
+    g_audio_state.harmony_duration_ms = audio_sounding_ms(duration_ms);
+}
+
+// Step the harmony voice: note, gap, next note - silent once its stream is done
+static void audio_update_harmony(uint16_t current_time)
+{
+    if (g_audio_state.harmony_phase == AUDIO_PHASE_IDLE ||
+        (uint16_t)(current_time - g_audio_state.harmony_start_time) < g_audio_state.harmony_duration_ms)
     {
         return;
     }
 
-    // Mark song as playing
-    g_audio_state.song_currently_playing = true;
-
-    // Validate parameters
-    if (duty_cycle_percent > 100)
-        duty_cycle_percent = 100;
-    if (duty_cycle_percent < 10)
-        duty_cycle_percent = 10; // Minimum for audible sound
-    if (speed_percent < 25)
-        speed_percent = 25; // Minimum 25% speed
-    if (speed_percent > 10000)
-        speed_percent = 10000; // Maximum 10000% speed (100x faster!)
-
-    // Clamp transposition to valid range
-    if (transpose_semitones < -12)
-        transpose_semitones = -12;
-    if (transpose_semitones > 12)
-        transpose_semitones = 12;
-
-    // Initialize audio hardware (ensure buzzer pin is output with maximum drive)
-    DDRB |= (1 << BUZZER_PIN);   // Set as output
-    PORTB &= ~(1 << BUZZER_PIN); // Start LOW for clean signal
-
-    // Play each note using bit-banging with configurable parameters
-    for (uint8_t i = 0; i < note_count; i++)
+    if (g_audio_state.harmony_phase == AUDIO_PHASE_GAP)
     {
-        audio_note_t note;
-        memcpy_P(&note, &melody_data[i], sizeof(audio_note_t));
-
-        // Apply transposition to frequency (0 = rest, unchanged)
-        uint16_t transposed_freq = transpose_frequency(note.frequency, transpose_semitones);
+        audio_start_harmony_note(current_time);
+        return;
+    }
 
-        // Apply speed scaling to duration
-        uint16_t scaled_duration = ((uint32_t)note.duration * 100) / speed_percent;
+    hardware_audio_dds_voice(1, 0);
+    if (--g_audio_state.harmony_notes_left == 0)
+    {
+        g_audio_state.harmony_phase = AUDIO_PHASE_IDLE;
+        return;
+    }
+    g_audio_state.harmony_phase = AUDIO_PHASE_GAP;
+    g_audio_state.harmony_start_time = current_time;
+    g_audio_state.harmony_duration_ms = g_audio_state.song.gap_ms;
+}
+#endif
 
-        // Trigger audio-reactive lighting based on ORIGINAL note frequency (not transposed)
-        // This keeps the light show matched to the musical pitch relationships as written
-        lighting_audio_reactive_note(note.frequency);
+// Start the silence between two notes (distinguishes identical consecutive notes)
+static void audio_start_gap(uint16_t current_time)
+{
+#if FEATURE_AUDIO_DDS
+    hardware_audio_dds_voice(0, 0); // The harmony voice keeps sounding
+#else
+    hardware_audio_stop();
+#endif
+    lighting_audio_reactive_release(); // LEDs decay during gaps
 
-        // Use configurable bit-banging method
-        audio_play_tone_blocking_configurable(transposed_freq, scaled_duration, duty_cycle_percent);
+    g_audio_state.phase = AUDIO_PHASE_GAP;
+    g_audio_state.phase_start_time = current_time;
+    g_audio_state.phase_duration_ms = g_audio_state.song.gap_ms;
+}
 
-        // Turn off audio-reactive LEDs during note gaps
-        // Add small gap between notes to distinguish identical consecutive notes
-        // Skip gap after the last note
-        if (i < note_count - 1)
-        {
-            lighting_audio_reactive_off(); // Turn off LEDs during gaps
-            uint16_t gap_duration = ((uint32_t)AUDIO_NOTE_GAP_MS * 100) / speed_percent;
-            audio_play_tone_blocking_configurable(0, gap_duration, duty_cycle_percent); // 0 frequency = silence
-        }
-    }
+// Song finished or stopped: silence, restore mic pin and arm the cooldown
+static void audio_finish_melody(void)
+{
+    hardware_audio_stop();
 
     // Turn off all audio-reactive LEDs when song ends
     lighting_audio_reactive_off();
 
-    // Restore microphone configuration after LED_3ER audio mode
-#if FEATURE_MICROPHONE_SENSOR
-    hardware_microphone_init(); // Reinitialize microphone (restores PB3 pin config)
-#endif
+    // No microphone re-init: the ADC setup survives songs, and with LED_3ER dark the PWM engine
+    // turns PB3 back into the microphone input on its next frame
 
     // Mark song as finished and set cooldown timing
     uint32_t current_time = hardware_get_millis();
+    g_audio_state.phase = AUDIO_PHASE_IDLE;
+#if FEATURE_AUDIO_DDS
+    g_audio_state.harmony_phase = AUDIO_PHASE_IDLE;
+#endif
     g_audio_state.song_currently_playing = false;
     g_audio_state.song_end_time = current_time;
     g_audio_state.cooldown_end_time = current_time + SONG_COOLDOWN_MS;
-
-    // Force sensor recalibration after audio playback to handle shared pin charge buildup
-#if FEATURE_MICROPHONE_SENSOR
-    sensors_force_recalibration();
-#endif
+    g_audio_state.cooldown_active = true;
+    // Shared pin charge buildup after playback is absorbed by the sensors' baseline tracker
 }
 
-// Configurable bit-banging function with duty cycle parameter
-static void audio_play_tone_blocking_configurable(uint16_t frequency, uint16_t duration_ms, uint8_t duty_cycle_percent)
+void audio_start_melody(melody_id_t melody_id)
 {
-    if (frequency == 0)
+    const audio_song_t *song = get_melody_data(melody_id);
+    
+    if (!song || pgm_read_byte(&song->note_count) == 0)
     {
-        // Rest (silence)
-        for (uint16_t i = 0; i < duration_ms; i++)
-        {
-            _delay_ms(1);
-        }
         return;
     }
 
-    // Calculate timing based on frequency
-    uint32_t period_us = 1000000UL / frequency;
+    memcpy_P(&g_audio_state.song, song, sizeof(audio_song_t));
+    g_audio_state.melody.cursor = g_audio_state.song.notes;
+    g_audio_state.melody.return_cursor = NULL;
+    g_audio_state.note_index = 0;
+
+    // Mark song as playing (a new start simply replaces a running song)
+    g_audio_state.song_currently_playing = true;
+
+    uint16_t current_time = hardware_get_ticks();
+#if FEATURE_AUDIO_DDS
+    bool has_harmony = g_audio_state.song.harmony != NULL && g_audio_state.song.harmony_count > 0;
+    hardware_audio_dds_start(g_audio_state.song.duty_scale, has_harmony ? 2 : 1);
 
-    // Calculate high and low times based on duty cycle percentage
-    uint32_t high_time_us = (period_us * duty_cycle_percent) / 100;
-    uint32_t low_time_us = period_us - high_time_us;
+    g_audio_state.harmony_phase = AUDIO_PHASE_IDLE;
+    if (has_harmony)
+    {
+        g_audio_state.harmony.cursor = g_audio_state.song.harmony;
+        g_audio_state.harmony.return_cursor = NULL;
+        g_audio_state.harmony_notes_left = g_audio_state.song.harmony_count;
+        audio_start_harmony_note(current_time);
+    }
+#endif
+    audio_start_note(current_time);
+}
 
-    const uint8_t delay_step_us = 5;
+void audio_update(void)
+{
+    if (g_audio_state.phase == AUDIO_PHASE_IDLE)
+    {
+        return;
+    }
 
-    // Calculate delay loops for high and low phases
-    uint32_t high_loops = high_time_us / delay_step_us;
-    uint32_t low_loops = low_time_us / delay_step_us;
-    uint8_t high_remainder = high_time_us % delay_step_us;
-    uint8_t low_remainder = low_time_us % delay_step_us;
+    uint16_t current_time = hardware_get_ticks();
 
-    uint32_t total_cycles = (uint32_t)frequency * duration_ms / 1000UL;
+#if FEATURE_AUDIO_DDS
+    audio_update_harmony(current_time);
+#endif
 
-    for (uint32_t i = 0; i < total_cycles; i++)
+    if ((uint16_t)(current_time - g_audio_state.phase_start_time) < g_audio_state.phase_duration_ms)
     {
-        // High phase (configurable duty cycle)
-        PORTB |= (1 << BUZZER_PIN);
-        for (uint32_t d = 0; d < high_loops; d++)
-        {
-            _delay_us(delay_step_us);
-        }
-        for (uint8_t r = 0; r < high_remainder; r++)
-        {
-            __asm__ __volatile__("nop\nnop\nnop\nnop");
-        }
+        return; // Current note or gap still running
+    }
 
-        // Low phase (remainder of period)
-        PORTB &= ~(1 << BUZZER_PIN);
-        for (uint32_t d = 0; d < low_loops; d++)
+    if (g_audio_state.phase == AUDIO_PHASE_NOTE)
+    {
+        // Skip gap after the last note
+        if (g_audio_state.note_index < g_audio_state.song.note_count - 1)
         {
-            _delay_us(delay_step_us);
+            audio_start_gap(current_time);
         }
-        for (uint8_t r = 0; r < low_remainder; r++)
+        else
         {
-            __asm__ __volatile__("nop\nnop\nnop\nnop");
+            audio_finish_melody();
         }
     }
-    PORTB &= ~(1 << BUZZER_PIN); // Ensure buzzer is off
+    else
+    {
+        g_audio_state.note_index++;
+        audio_start_note(current_time);
+    }
+}
+
+void audio_stop_melody(void)
+{
+    if (g_audio_state.song_currently_playing)
+    {
+        audio_finish_melody();
+    }
+}
+
+void audio_play_melody_blocking(melody_id_t melody_id)
+{
+    // Run the sequencer to completion (LED PWM keeps running in its timer ISR)
+    audio_start_melody(melody_id);
+    while (audio_is_song_playing())
+    {
+        audio_update();
+        hardware_idle();
+    }
 }
 
 void audio_play_next_melody(void)
@@ -326,17 +499,15 @@ void audio_play_next_melody(void)
     g_audio_state.song_rotation_index = (g_audio_state.song_rotation_index + 1) % ENABLED_SONG_COUNT;
 #endif
 
-    // Save the new rotation index to EEPROM for persistence across resets
-    hardware_eeprom_write_byte(EEPROM_ADDR_SONG_ROTATION_INDEX, g_audio_state.song_rotation_index);
+    // Save the new rotation index to EEPROM for persistence across resets (non-blocking, wear-leveled)
+    audio_rotation_save();
 
     melody_id_t next_melody = enabled_songs[g_audio_state.song_rotation_index];
-    // Use individual song configuration for optimal playback
-    const song_config_t *config = get_song_config(next_melody);
-    audio_play_melody_blocking(next_melody, config->duty_cycle_percent, config->speed_percent, config->transpose_semitones);
+    // Individual song configuration is baked into the song data
+    audio_start_melody(next_melody);
 #else
     // Rotation disabled, play default song with its individual configuration
-    const song_config_t *config = get_song_config(MELODY_OH_TANNENBAUM);
-    audio_play_melody_blocking(MELODY_OH_TANNENBAUM, config->duty_cycle_percent, config->speed_percent, config->transpose_semitones);
+    audio_start_melody(MELODY_OH_TANNENBAUM);
 #endif
 }
 
@@ -358,13 +529,11 @@ void audio_play_current_melody(void)
     }
 
     melody_id_t current_melody = enabled_songs[g_audio_state.song_rotation_index];
-    // Use individual song configuration for optimal playback
-    const song_config_t *config = get_song_config(current_melody);
-    audio_play_melody_blocking(current_melody, config->duty_cycle_percent, config->speed_percent, config->transpose_semitones);
+    // Individual song configuration is baked into the song data
+    audio_start_melody(current_melody);
 #else
     // Rotation disabled, play default song with its individual configuration
-    const song_config_t *config = get_song_config(MELODY_OH_TANNENBAUM);
-    audio_play_melody_blocking(MELODY_OH_TANNENBAUM, config->duty_cycle_percent, config->speed_percent, config->transpose_semitones);
+    audio_start_melody(MELODY_OH_TANNENBAUM);
 #endif
 }
 
@@ -382,8 +551,11 @@ bool audio_is_song_playing(void)
 
 bool audio_is_cooldown_expired(void)
 {
-    uint32_t current_time = hardware_get_millis();
-    return (current_time >= g_audio_state.cooldown_end_time);
+    if (g_audio_state.cooldown_active && hardware_get_millis() >= g_audio_state.cooldown_end_time)
+    {
+        g_audio_state.cooldown_active = false;
+    }
+    return !g_audio_state.cooldown_active;
 }
 
 #endif // FEATURE_AUDIO_OUTPUT
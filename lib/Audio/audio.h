@@ -33,50 +33,52 @@ extern "C"
 // NOTE DEFINITIONS
 // ============================================================================
 
-// Musical note frequencies (in Hz) - Fine-tuned for ATtiny85 buzzer
+// Musical note frequencies (in Hz) - equal temperament, A4 = 440 Hz
+// Rounded values for the lighting thresholds, the tone itself comes from the generated
+// audio_pitch_timers[] / audio_pitch_dds_steps[] tables
 // Lower octave notes
-#define NOTE_G3 128
-#define NOTE_GS3 136
-#define NOTE_A3 144
-#define NOTE_AS3 153
-#define NOTE_B3 162
+#define NOTE_G3 196
+#define NOTE_GS3 208
+#define NOTE_A3 220
+#define NOTE_AS3 233
+#define NOTE_B3 247
 
 // Fourth octave notes
-#define NOTE_C4 172
-#define NOTE_CS4 182
-#define NOTE_D4 192
-#define NOTE_DS4 204
-#define NOTE_E4 216
-#define NOTE_F4 229
-#define NOTE_FS4 243
-#define NOTE_G4 257 
-#define NOTE_GS4 273
-#define NOTE_A4 290 
-#define NOTE_AS4 307
-#define NOTE_B4 326
-#define NOTE_C5 344
-#define NOTE_CS5 365
-#define NOTE_D5 386
-#define NOTE_DS5 408
-#define NOTE_E5 433
-#define NOTE_F5 459
-#define NOTE_FS5 486
-#define NOTE_G5 515
-#define NOTE_GS5 546
-#define NOTE_A5 580
-#define NOTE_AS5 614
-#define NOTE_B5 652
-#define NOTE_C6 690
-#define NOTE_CS6 730
-#define NOTE_D6 773
-#define NOTE_DS6 818
-#define NOTE_E6 866
-#define NOTE_F6 918
-#define NOTE_FS6 972
-#define NOTE_G6 1030
-#define NOTE_GS6 1092
-#define NOTE_A6 1160
-#define NOTE_AS6 1228
+#define NOTE_C4 262
+#define NOTE_CS4 277
+#define NOTE_D4 294
+#define NOTE_DS4 311
+#define NOTE_E4 330
+#define NOTE_F4 349
+#define NOTE_FS4 370
+#define NOTE_G4 392
+#define NOTE_GS4 415
+#define NOTE_A4 440
+#define NOTE_AS4 466
+#define NOTE_B4 494
+#define NOTE_C5 523
+#define NOTE_CS5 554
+#define NOTE_D5 587
+#define NOTE_DS5 622
+#define NOTE_E5 659
+#define NOTE_F5 698
+#define NOTE_FS5 740
+#define NOTE_G5 784
+#define NOTE_GS5 831
+#define NOTE_A5 880
+#define NOTE_AS5 932
+#define NOTE_B5 988
+#define NOTE_C6 1047
+#define NOTE_CS6 1109
+#define NOTE_D6 1175
+#define NOTE_DS6 1245
+#define NOTE_E6 1319
+#define NOTE_F6 1397
+#define NOTE_FS6 1480
+#define NOTE_G6 1568
+#define NOTE_GS6 1661
+#define NOTE_A6 1760
+#define NOTE_AS6 1865
 
 // Special notes
 #define NOTE_REST 0
@@ -92,22 +94,54 @@ extern "C"
     // MELODY DEFINITIONS
     // ============================================================================
 
-    // Note structure for melodies
+    // Packed note format (PROGMEM byte stream, 1-2 bytes per note)
+    //   byte 0 bits 5-0: pitch index (0 = NOTE_G3 ... 39 = NOTE_AS6, one semitone per step)
+    //   byte 0 bits 7-6: duration code 0-2 = audio_song_t.duration_ticks[code]
+    //                    duration code 3   = tick count follows in byte 1
+    // Note duration = ticks * audio_song_t.tick_ms (pitch and tick_ms already include the
+    // song's transpose and speed from config.yaml, applied by the generator)
+    // Control codes: AUDIO_PITCH_SEGMENT + index byte plays a shared phrase from
+    // audio_segment_notes[] (no nesting), AUDIO_PITCH_RETURN ends that phrase
+#define AUDIO_PITCH_COUNT 40
+#define AUDIO_PITCH_MASK 0x3F
+#define AUDIO_PITCH_RETURN 61
+#define AUDIO_PITCH_SEGMENT 62
+#define AUDIO_PITCH_REST 63
+#define AUDIO_DURATION_SHIFT 6
+#define AUDIO_DURATION_EXPLICIT 3
+
+    // Timer1 setting of one pitch index - generated for F_CPU from equal-tempered pitch
+    // f_tone = F_CPU / (2^(clock_select - 1) * (top + 1)), see audio_pitch_timers[]
     typedef struct
     {
-        uint16_t frequency; // Frequency in Hz (0 = rest)
-        uint16_t duration;  // Duration in milliseconds
-    } audio_note_t;
+        uint8_t clock_select; // TCCR1 CS13:0 (1 = CK/1 ... 15 = CK/16384)
+        uint8_t top;          // OCR1C
+    } audio_pitch_timer_t;
 
-    // Melody structure (deprecated - kept for compatibility)
+    // Packed song descriptor (stored in PROGMEM next to its note stream)
     typedef struct
     {
-        const audio_note_t *notes;
-        uint8_t note_count;
-        bool loop;
-    } audio_melody_t;
+        const uint8_t *notes;      // Packed note stream (PROGMEM)
+        uint16_t tick_ms;          // Duration unit of this song in milliseconds
+        uint8_t note_count;        // Number of notes in the stream
+        uint8_t duration_ticks[3]; // Tick counts for duration codes 0-2
+        uint8_t gap_ms;            // Silence between notes (speed scaled)
+        uint8_t duty_scale;         // Tone duty cycle in 1/256 (config.yaml percent * 256 / 100)
+        int8_t transpose_semitones; // Transposition baked into the pitches (undone for lighting)
+#if FEATURE_AUDIO_DDS
+        const uint8_t *harmony;     // Second voice stream, same packed format and tick table (NULL = none)
+        uint8_t harmony_count;      // Number of notes in the harmony stream
+#endif
+    } audio_song_t;
+
+    // Trailing harmony fields of a generated descriptor (dropped without the DDS engine)
+#if FEATURE_AUDIO_DDS
+#define AUDIO_SONG_HARMONY(notes, count) , notes, count
+#else
+#define AUDIO_SONG_HARMONY(notes, count)
+#endif
 
-    // Song configuration structure for individual playback settings
+    // Song configuration structure for individual playback settings (as listed in config.yaml)
     typedef struct
     {
         uint8_t duty_cycle_percent;  // Duty cycle percentage (10-100)
@@ -122,11 +156,14 @@ extern "C"
     // AUDIO SYSTEM FUNCTIONS
     // ============================================================================
 
-    // Core blocking audio functions
+    // Core audio functions
     bool audio_init(void);                                                                                                          // Initialize audio system and load persistent state
-    void audio_play_melody_blocking(melody_id_t melody_id, uint8_t duty_cycle_percent, uint16_t speed_percent, int8_t transpose_semitones); // Play melody with blocking execution
-    void audio_play_next_melody(void);                                                                                              // Play next song in rotation (blocking)
-    void audio_play_current_melody(void);                                                                                           // Play current song in rotation (blocking)
+    void audio_start_melody(melody_id_t melody_id);                                                                                 // Start melody on the non-blocking sequencer (song settings are baked in)
+    void audio_update(void);                                                                                                        // Step notes and gaps - call once per main loop iteration
+    void audio_stop_melody(void);                                                                                                   // Stop the current song early (starts cooldown)
+    void audio_play_melody_blocking(melody_id_t melody_id);                                                                         // Play melody to completion (runs the sequencer in place)
+    void audio_play_next_melody(void);                                                                                              // Start next song in rotation (non-blocking)
+    void audio_play_current_melody(void);                                                                                           // Start current song in rotation (non-blocking)
     song_config_t audio_get_song_config(melody_id_t melody_id);                                                                     // Get individual song configuration
 
     // Song state tracking functions
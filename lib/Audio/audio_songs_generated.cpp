@@ -14,295 +14,356 @@
 #include "../../config/config.h"
 #include <avr/pgmspace.h>
 
+// ============================================================================
+// PITCH TABLES - Timer1 and DDS settings per pitch index, no runtime division
+// ============================================================================
+
+// Pitch tables: equal temperament (A4 = 440 Hz) at F_CPU = 8000000, indexed by packed pitch index
+#if F_CPU != 8000000
+#error "Pitch tables were generated for another F_CPU - rerun scripts/generate_audio_code.py --f-cpu"
+#endif
+
+// Square tone: f = F_CPU / (2^(clock_select - 1) * (top + 1)), worst error 5.7 cents
+const audio_pitch_timer_t PROGMEM audio_pitch_timers[AUDIO_PITCH_COUNT] = {
+    {9, 158},  // 0  G3    196.00 Hz ->  196.54 Hz (+4.8 cents)
+    {9, 149},  // 1  GS3   207.65 Hz ->  208.33 Hz (+5.7 cents)
+    {9, 141},  // 2  A3    220.00 Hz ->  220.07 Hz (+0.6 cents)
+    {9, 133},  // 3  AS3   233.08 Hz ->  233.21 Hz (+0.9 cents)
+    {8, 252},  // 4  B3    246.94 Hz ->  247.04 Hz (+0.7 cents)
+    {8, 238},  // 5  C4    261.63 Hz ->  261.51 Hz (-0.8 cents)
+    {8, 224},  // 6  CS4   277.18 Hz ->  277.78 Hz (+3.7 cents)
+    {8, 212},  // 7  D4    293.66 Hz ->  293.43 Hz (-1.4 cents)
+    {8, 200},  // 8  DS4   311.13 Hz ->  310.95 Hz (-1.0 cents)
+    {8, 189},  // 9  E4    329.63 Hz ->  328.95 Hz (-3.6 cents)
+    {8, 178},  // 10 F4    349.23 Hz ->  349.16 Hz (-0.3 cents)
+    {8, 168},  // 11 FS4   369.99 Hz ->  369.82 Hz (-0.8 cents)
+    {8, 158},  // 12 G4    392.00 Hz ->  393.08 Hz (+4.8 cents)
+    {8, 149},  // 13 GS4   415.30 Hz ->  416.67 Hz (+5.7 cents)
+    {8, 141},  // 14 A4    440.00 Hz ->  440.14 Hz (+0.6 cents)
+    {8, 133},  // 15 AS4   466.16 Hz ->  466.42 Hz (+0.9 cents)
+    {7, 252},  // 16 B4    493.88 Hz ->  494.07 Hz (+0.7 cents)
+    {7, 238},  // 17 C5    523.25 Hz ->  523.01 Hz (-0.8 cents)
+    {7, 224},  // 18 CS5   554.37 Hz ->  555.56 Hz (+3.7 cents)
+    {7, 212},  // 19 D5    587.33 Hz ->  586.85 Hz (-1.4 cents)
+    {7, 200},  // 20 DS5   622.25 Hz ->  621.89 Hz (-1.0 cents)
+    {7, 189},  // 21 E5    659.26 Hz ->  657.89 Hz (-3.6 cents)
+    {7, 178},  // 22 F5    698.46 Hz ->  698.32 Hz (-0.3 cents)
+    {7, 168},  // 23 FS5   739.99 Hz ->  739.64 Hz (-0.8 cents)
+    {7, 158},  // 24 G5    783.99 Hz ->  786.16 Hz (+4.8 cents)
+    {7, 149},  // 25 GS5   830.61 Hz ->  833.33 Hz (+5.7 cents)
+    {7, 141},  // 26 A5    880.00 Hz ->  880.28 Hz (+0.6 cents)
+    {7, 133},  // 27 AS5   932.33 Hz ->  932.84 Hz (+0.9 cents)
+    {6, 252},  // 28 B5    987.77 Hz ->  988.14 Hz (+0.7 cents)
+    {6, 238},  // 29 C6   1046.50 Hz -> 1046.03 Hz (-0.8 cents)
+    {6, 224},  // 30 CS6  1108.73 Hz -> 1111.11 Hz (+3.7 cents)
+    {6, 212},  // 31 D6   1174.66 Hz -> 1173.71 Hz (-1.4 cents)
+    {6, 200},  // 32 DS6  1244.51 Hz -> 1243.78 Hz (-1.0 cents)
+    {6, 189},  // 33 E6   1318.51 Hz -> 1315.79 Hz (-3.6 cents)
+    {6, 178},  // 34 F6   1396.91 Hz -> 1396.65 Hz (-0.3 cents)
+    {6, 168},  // 35 FS6  1479.98 Hz -> 1479.29 Hz (-0.8 cents)
+    {6, 158},  // 36 G6   1567.98 Hz -> 1572.33 Hz (+4.8 cents)
+    {6, 149},  // 37 GS6  1661.22 Hz -> 1666.67 Hz (+5.7 cents)
+    {6, 141},  // 38 A6   1760.00 Hz -> 1760.56 Hz (+0.6 cents)
+    {6, 133},  // 39 AS6  1864.66 Hz -> 1865.67 Hz (+0.9 cents)
+};
+
+#if FEATURE_AUDIO_DDS
+// DDS phase steps: step = f * 65536 / (F_CPU / 256), worst error 1.9 cents
+const uint16_t PROGMEM audio_pitch_dds_steps[AUDIO_PITCH_COUNT] = {
+    411,   // 0  G3
+    435,   // 1  GS3
+    461,   // 2  A3
+    489,   // 3  AS3
+    518,   // 4  B3
+    549,   // 5  C4
+    581,   // 6  CS4
+    616,   // 7  D4
+    652,   // 8  DS4
+    691,   // 9  E4
+    732,   // 10 F4
+    776,   // 11 FS4
+    822,   // 12 G4
+    871,   // 13 GS4
+    923,   // 14 A4
+    978,   // 15 AS4
+    1036,  // 16 B4
+    1097,  // 17 C5
+    1163,  // 18 CS5
+    1232,  // 19 D5
+    1305,  // 20 DS5
+    1383,  // 21 E5
+    1465,  // 22 F5
+    1552,  // 23 FS5
+    1644,  // 24 G5
+    1742,  // 25 GS5
+    1845,  // 26 A5
+    1955,  // 27 AS5
+    2071,  // 28 B5
+    2195,  // 29 C6
+    2325,  // 30 CS6
+    2463,  // 31 D6
+    2610,  // 32 DS6
+    2765,  // 33 E6
+    2930,  // 34 F6
+    3104,  // 35 FS6
+    3288,  // 36 G6
+    3484,  // 37 GS6
+    3691,  // 38 A6
+    3910,  // 39 AS6
+};
+#endif
+
 // ============================================================================
 // MELODY DATA - Generated from MusicXML files
 // All melody data stored in PROGMEM to save RAM
 // ============================================================================
 
-// Song: JINGLE_BELLS (28 notes)
-static const audio_note_t PROGMEM melody_jingle_bells[] = {
-    {326, 500},
-    {326, 500},
-    {326, 1000},
-    {326, 500},
-    {326, 500},
-    {326, 1000},
-    {326, 500},
-    {386, 500},
-    {257, 750},
-    {290, 250},
-    {326, 1500},
-    {0, 500},
-    {344, 500},
-    {344, 500},
-    {344, 750},
-    {344, 250},
-    {344, 500},
-    {326, 500},
-    {326, 500},
-    {326, 250},
-    {326, 250},
-    {326, 500},
-    {290, 500},
-    {290, 500},
-    {326, 500},
-    {290, 1000},
-    {386, 1000},
-    {0, 2000},
+// Shared segments: 3 repeated phrases, played via AUDIO_PITCH_SEGMENT
+// Durations are decoded with the tick table of the calling song
+const uint8_t PROGMEM audio_segment_notes[] = {
+    // Segment 0
+    0x09,      // E4   duration code 0
+    0x8E,      // A4   duration code 2
+    0xCE, 1,   // A4   1 ticks
+    0x0E,      // A4   duration code 0
+    0x10,      // B4   duration code 0
+    0x92,      // CS5  duration code 2
+    0xD2, 1,   // CS5  1 ticks
+    0x12,      // CS5  duration code 0
+    0x12,      // CS5  duration code 0
+    0x50,      // B4   duration code 1
+    0x52,      // CS5  duration code 1
+    0x13,      // D5   duration code 0
+    0x0D,      // GS4  duration code 0
+    0x10,      // B4   duration code 0
+    0x3D,      // end of segment 0
+    // Segment 1
+    0x47,      // D4   duration code 1
+    0x0B,      // FS4  duration code 0
+    0x07,      // D4   duration code 0
+    0x0B,      // FS4  duration code 0
+    0x0E,      // A4   duration code 0
+    0x47,      // D4   duration code 1
+    0x0B,      // FS4  duration code 0
+    0x07,      // D4   duration code 0
+    0x09,      // E4   duration code 0
+    0x02,      // A3   duration code 0
+    0x3D,      // end of segment 1
+    // Segment 2
+    0x8D,      // GS4  duration code 2
+    0xCF, 1,   // AS4  1 ticks
+    0x0D,      // GS4  duration code 0
+    0x4A,      // F4   duration code 1
+    0x3D,      // end of segment 2
 };
 
-// Song: Oh_Tannenbaum (47 notes)
-static const audio_note_t PROGMEM melody_oh_tannenbaum[] = {
-    {192, 500},
-    {257, 375},
-    {257, 125},
-    {257, 500},
-    {290, 500},
-    {326, 375},
-    {326, 125},
-    {326, 500},
-    {326, 500},
-    {290, 250},
-    {326, 250},
-    {344, 500},
-    {243, 500},
-    {290, 500},
-    {257, 500},
-    {0, 250},
-    {386, 250},
-    {386, 250},
-    {326, 250},
-    {433, 750},
-    {386, 250},
-    {386, 250},
-    {344, 250},
-    {344, 750},
-    {344, 250},
-    {344, 250},
-    {290, 250},
-    {386, 750},
-    {344, 250},
-    {344, 250},
-    {326, 250},
-    {326, 500},
-    {192, 500},
-    {257, 375},
-    {257, 125},
-    {257, 500},
-    {290, 500},
-    {326, 375},
-    {326, 125},
-    {326, 500},
-    {326, 500},
-    {290, 250},
-    {326, 250},
-    {344, 500},
-    {243, 500},
-    {290, 500},
-    {257, 1000},
+const uint16_t PROGMEM audio_segment_offsets[] = {
+    0, 17, 28,
 };
 
-// Song: Oh_du_frohliche (21 notes)
-static const audio_note_t PROGMEM melody_oh_du_frohliche[] = {
-    {290, 1000},
-    {326, 1000},
-    {290, 750},
-    {257, 250},
-    {243, 500},
-    {257, 500},
-    {290, 1000},
-    {326, 1000},
-    {290, 750},
-    {257, 250},
-    {243, 500},
-    {257, 500},
-    {290, 1000},
-    {290, 1000},
-    {326, 1000},
-    {365, 500},
-    {386, 500},
-    {365, 1000},
-    {326, 1000},
-    {290, 1500},
-    {0, 500},
+// Song: JINGLE_BELLS (28 notes, 32 bytes packed, 139 ms tick)
+static const uint8_t PROGMEM melody_jingle_bells_notes[] = {
+    0x0F,      // AS4  278 ms
+    0x0F,      // AS4  278 ms
+    0x4F,      // AS4  556 ms
+    0x0F,      // AS4  278 ms
+    0x0F,      // AS4  278 ms
+    0x4F,      // AS4  556 ms
+    0x0F,      // AS4  278 ms
+    0x12,      // CS5  278 ms
+    0xCB, 3,   // FS4  417 ms
+    0x8D,      // GS4  139 ms
+    0xCF, 6,   // AS4  834 ms
+    0x3F,      // REST 278 ms
+    0x10,      // B4   278 ms
+    0x10,      // B4   278 ms
+    0xD0, 3,   // B4   417 ms
+    0x90,      // B4   139 ms
+    0x10,      // B4   278 ms
+    0x0F,      // AS4  278 ms
+    0x0F,      // AS4  278 ms
+    0x8F,      // AS4  139 ms
+    0x8F,      // AS4  139 ms
+    0x0F,      // AS4  278 ms
+    0x0D,      // GS4  278 ms
+    0x0D,      // GS4  278 ms
+    0x0F,      // AS4  278 ms
+    0x4D,      // GS4  556 ms
+    0x52,      // CS5  556 ms
+    0xFF, 8,   // REST 1112 ms
 };
+static const audio_song_t PROGMEM melody_jingle_bells = {melody_jingle_bells_notes, 139, 28, {2, 4, 1}, 28, 218, -1 AUDIO_SONG_HARMONY(NULL, 0)};
 
-// Song: Schneeflockchen_Weissrockchen (26 notes)
-static const audio_note_t PROGMEM melody_schneeflockchen_weissrockchen[] = {
-    {326, 250},
-    {344, 250},
-    {386, 500},
-    {386, 500},
-    {433, 500},
-    {290, 500},
-    {290, 500},
-    {290, 250},
-    {326, 250},
-    {344, 500},
-    {344, 500},
-    {386, 500},
-    {326, 1000},
-    {326, 250},
-    {344, 250},
-    {386, 500},
-    {386, 500},
-    {515, 500},
-    {486, 500},
-    {433, 500},
-    {386, 250},
-    {344, 250},
-    {326, 500},
-    {344, 500},
-    {290, 500},
-    {257, 1000},
+// Song: Oh_Tannenbaum (47 notes, 27 bytes packed, 83 ms tick)
+static const uint8_t PROGMEM melody_oh_tannenbaum_notes[] = {
+    0x3E, 0,   // segment 0 (14 notes)
+    0x0E,      // A4   332 ms
+    0x7F,      // REST 166 ms
+    0x55,      // E5   166 ms
+    0x55,      // E5   166 ms
+    0x52,      // CS5  166 ms
+    0xD7, 6,   // FS5  498 ms
+    0x55,      // E5   166 ms
+    0x55,      // E5   166 ms
+    0x53,      // D5   166 ms
+    0xD3, 6,   // D5   498 ms
+    0x53,      // D5   166 ms
+    0x53,      // D5   166 ms
+    0x50,      // B4   166 ms
+    0xD5, 6,   // E5   498 ms
+    0x53,      // D5   166 ms
+    0x53,      // D5   166 ms
+    0x52,      // CS5  166 ms
+    0x12,      // CS5  332 ms
+    0x3E, 0,   // segment 0 (14 notes)
+    0xCE, 8,   // A4   664 ms
 };
+static const audio_song_t PROGMEM melody_oh_tannenbaum = {melody_oh_tannenbaum_notes, 83, 47, {4, 2, 3}, 33, 192, 2 AUDIO_SONG_HARMONY(NULL, 0)};
 
-// Song: Stille_Nacht_ChipVersion (23 notes)
-static const audio_note_t PROGMEM melody_stille_nacht_chipversion[] = {
-    {257, 750},
-    {290, 250},
-    {257, 500},
-    {216, 1500},
-    {257, 750},
-    {290, 250},
-    {257, 500},
-    {216, 1500},
-    {386, 1000},
-    {386, 500},
-    {326, 1500},
-    {344, 1000},
-    {344, 500},
-    {257, 1500},
-    {290, 1000},
-    {290, 500},
-    {344, 750},
-    {326, 250},
-    {290, 500},
-    {257, 750},
-    {290, 250},
-    {257, 500},
-    {216, 1500},
+// Song: Oh_du_frohliche (21 notes, 24 bytes packed, 147 ms tick)
+static const uint8_t PROGMEM melody_oh_du_frohliche_notes[] = {
+    0x0F,      // AS4  588 ms
+    0x11,      // C5   588 ms
+    0x8F,      // AS4  441 ms
+    0xCD, 1,   // GS4  147 ms
+    0x4C,      // G4   294 ms
+    0x4D,      // GS4  294 ms
+    0x0F,      // AS4  588 ms
+    0x11,      // C5   588 ms
+    0x8F,      // AS4  441 ms
+    0xCD, 1,   // GS4  147 ms
+    0x4C,      // G4   294 ms
+    0x4D,      // GS4  294 ms
+    0x0F,      // AS4  588 ms
+    0x0F,      // AS4  588 ms
+    0x11,      // C5   588 ms
+    0x53,      // D5   294 ms
+    0x54,      // DS5  294 ms
+    0x13,      // D5   588 ms
+    0x11,      // C5   588 ms
+    0xCF, 6,   // AS4  882 ms
+    0x7F,      // REST 294 ms
 };
+static const audio_song_t PROGMEM melody_oh_du_frohliche = {melody_oh_du_frohliche_notes, 147, 21, {4, 2, 3}, 29, 218, 1 AUDIO_SONG_HARMONY(NULL, 0)};
 
-// Song: The_First_Noel_Trumpet_only (27 notes)
-static const audio_note_t PROGMEM melody_the_first_noel_trumpet_only[] = {
-    {0, 1000},
-    {216, 250},
-    {192, 250},
-    {172, 750},
-    {192, 250},
-    {216, 250},
-    {229, 250},
-    {257, 1000},
-    {290, 250},
-    {326, 250},
-    {344, 500},
-    {326, 500},
-    {290, 500},
-    {257, 1000},
-    {290, 250},
-    {326, 250},
-    {344, 500},
-    {326, 500},
-    {290, 500},
-    {257, 500},
-    {290, 500},
-    {326, 500},
-    {344, 500},
-    {257, 500},
-    {229, 500},
-    {216, 1000},
-    {0, 500},
+// Song: Schneeflockchen_Weissrockchen (26 notes, 26 bytes packed, 179 ms tick)
+static const uint8_t PROGMEM melody_schneeflockchen_weissrockchen_notes[] = {
+    0x50,      // B4   179 ms
+    0x51,      // C5   179 ms
+    0x13,      // D5   358 ms
+    0x13,      // D5   358 ms
+    0x15,      // E5   358 ms
+    0x0E,      // A4   358 ms
+    0x0E,      // A4   358 ms
+    0x4E,      // A4   179 ms
+    0x50,      // B4   179 ms
+    0x11,      // C5   358 ms
+    0x11,      // C5   358 ms
+    0x13,      // D5   358 ms
+    0x90,      // B4   716 ms
+    0x50,      // B4   179 ms
+    0x51,      // C5   179 ms
+    0x13,      // D5   358 ms
+    0x13,      // D5   358 ms
+    0x18,      // G5   358 ms
+    0x17,      // FS5  358 ms
+    0x15,      // E5   358 ms
+    0x53,      // D5   179 ms
+    0x51,      // C5   179 ms
+    0x10,      // B4   358 ms
+    0x11,      // C5   358 ms
+    0x0E,      // A4   358 ms
+    0x8C,      // G4   716 ms
 };
+static const audio_song_t PROGMEM melody_schneeflockchen_weissrockchen = {melody_schneeflockchen_weissrockchen_notes, 179, 26, {2, 1, 4}, 36, 192, 0 AUDIO_SONG_HARMONY(NULL, 0)};
 
-// Song: kommet-ihr-hirten (44 notes)
-static const audio_note_t PROGMEM melody_kommet_ihr_hirten[] = {
-    {344, 500},
-    {344, 250},
-    {290, 250},
-    {386, 250},
-    {307, 250},
-    {344, 500},
-    {344, 250},
-    {290, 250},
-    {386, 250},
-    {307, 250},
-    {344, 500},
-    {290, 250},
-    {344, 250},
-    {257, 250},
-    {290, 250},
-    {229, 1000},
-    {0, 500},
-    {229, 500},
-    {290, 250},
-    {229, 250},
-    {290, 250},
-    {344, 250},
-    {229, 500},
-    {290, 250},
-    {229, 250},
-    {257, 250},
-    {172, 250},
-    {229, 500},
-    {290, 250},
-    {229, 250},
-    {290, 250},
-    {344, 250},
-    {229, 500},
-    {290, 250},
-    {229, 250},
-    {257, 250},
-    {172, 250},
-    {344, 500},
-    {290, 250},
-    {344, 250},
-    {257, 250},
-    {290, 250},
-    {229, 1000},
-    {0, 500},
+// Song: Stille_Nacht_ChipVersion (23 notes, 21 bytes packed, 167 ms tick)
+static const uint8_t PROGMEM melody_stille_nacht_chipversion_notes[] = {
+    0x3E, 2,   // segment 2 (4 notes)
+    0x3E, 2,   // segment 2 (4 notes)
+    0xD4, 4,   // DS5  668 ms
+    0x14,      // DS5  334 ms
+    0x51,      // C5   1002 ms
+    0xD2, 4,   // CS5  668 ms
+    0x12,      // CS5  334 ms
+    0x4D,      // GS4  1002 ms
+    0xCF, 4,   // AS4  668 ms
+    0x0F,      // AS4  334 ms
+    0x92,      // CS5  501 ms
+    0xD1, 1,   // C5   167 ms
+    0x0F,      // AS4  334 ms
+    0x3E, 2,   // segment 2 (4 notes)
 };
+static const audio_song_t PROGMEM melody_stille_nacht_chipversion = {melody_stille_nacht_chipversion_notes, 167, 23, {2, 6, 3}, 33, 192, 1 AUDIO_SONG_HARMONY(NULL, 0)};
 
-// Song: traditional-music-i-saw-three-ships-come-sailing-in (32 notes)
-static const audio_note_t PROGMEM melody_traditional_music_i_saw_three_ships_come_sailing_in[] = {
-    {192, 250},
-    {257, 500},
-    {257, 250},
-    {290, 500},
-    {326, 250},
-    {386, 500},
-    {326, 250},
-    {290, 500},
-    {344, 250},
-    {326, 500},
-    {257, 250},
-    {257, 500},
-    {326, 250},
-    {290, 500},
-    {243, 250},
-    {192, 500},
-    {192, 250},
-    {257, 500},
-    {257, 250},
-    {290, 500},
-    {326, 250},
-    {386, 500},
-    {326, 250},
-    {290, 500},
-    {344, 250},
-    {326, 500},
-    {257, 250},
-    {257, 250},
-    {290, 250},
-    {326, 250},
-    {290, 750},
-    {257, 500},
+// Song: The_First_Noel_Trumpet_only (27 notes, 28 bytes packed, 179 ms tick)
+static const uint8_t PROGMEM melody_the_first_noel_trumpet_only_notes[] = {
+    0xBF,      // REST 716 ms
+    0x4A,      // F4   179 ms
+    0x48,      // DS4  179 ms
+    0xC6, 3,   // CS4  537 ms
+    0x48,      // DS4  179 ms
+    0x4A,      // F4   179 ms
+    0x4B,      // FS4  179 ms
+    0x8D,      // GS4  716 ms
+    0x4F,      // AS4  179 ms
+    0x51,      // C5   179 ms
+    0x12,      // CS5  358 ms
+    0x11,      // C5   358 ms
+    0x0F,      // AS4  358 ms
+    0x8D,      // GS4  716 ms
+    0x4F,      // AS4  179 ms
+    0x51,      // C5   179 ms
+    0x12,      // CS5  358 ms
+    0x11,      // C5   358 ms
+    0x0F,      // AS4  358 ms
+    0x0D,      // GS4  358 ms
+    0x0F,      // AS4  358 ms
+    0x11,      // C5   358 ms
+    0x12,      // CS5  358 ms
+    0x0D,      // GS4  358 ms
+    0x0B,      // FS4  358 ms
+    0x8A,      // F4   716 ms
+    0x3F,      // REST 358 ms
 };
+static const audio_song_t PROGMEM melody_the_first_noel_trumpet_only = {melody_the_first_noel_trumpet_only_notes, 179, 27, {2, 1, 4}, 36, 205, 1 AUDIO_SONG_HARMONY(NULL, 0)};
 
-// Test tone: 5-second A4 note
-static const audio_note_t PROGMEM melody_test_tone[] = {
-    {440, 5000},  // A4 for 5 seconds
+// Song: kommet-ihr-hirten (44 notes, 28 bytes packed, 156 ms tick)
+static const uint8_t PROGMEM melody_kommet_ihr_hirten_notes[] = {
+    0x4E,      // A4   312 ms
+    0x0E,      // A4   156 ms
+    0x0B,      // FS4  156 ms
+    0x10,      // B4   156 ms
+    0x0C,      // G4   156 ms
+    0x4E,      // A4   312 ms
+    0x0E,      // A4   156 ms
+    0x0B,      // FS4  156 ms
+    0x10,      // B4   156 ms
+    0x0C,      // G4   156 ms
+    0x4E,      // A4   312 ms
+    0x0B,      // FS4  156 ms
+    0x0E,      // A4   156 ms
+    0x09,      // E4   156 ms
+    0x0B,      // FS4  156 ms
+    0x87,      // D4   624 ms
+    0x7F,      // REST 312 ms
+    0x3E, 1,   // segment 1 (10 notes)
+    0x3E, 1,   // segment 1 (10 notes)
+    0x4E,      // A4   312 ms
+    0x0B,      // FS4  156 ms
+    0x0E,      // A4   156 ms
+    0x09,      // E4   156 ms
+    0x0B,      // FS4  156 ms
+    0x87,      // D4   624 ms
+    0x7F,      // REST 312 ms
 };
+static const audio_song_t PROGMEM melody_kommet_ihr_hirten = {melody_kommet_ihr_hirten_notes, 156, 44, {1, 2, 4}, 31, 205, -3 AUDIO_SONG_HARMONY(NULL, 0)};
+
+// Song: Test tone (1 notes, 1 bytes packed, 5000 ms tick)
+static const uint8_t PROGMEM melody_test_tone_notes[] = {
+    0x0E,      // A4   5000 ms
+};
+static const audio_song_t PROGMEM melody_test_tone = {melody_test_tone_notes, 5000, 1, {1, 2, 4}, 50, 205, 0 AUDIO_SONG_HARMONY(NULL, 0)};
 
 
 // ============================================================================
@@ -311,19 +372,19 @@ static const audio_note_t PROGMEM melody_test_tone[] = {
 
 static const song_config_t song_configs[] = {
     [MELODY_NONE] = {50, 100, 0},  // Default fallback
-    [MELODY_JINGLE_BELLS] = {85, 180, 6},  // JINGLE_BELLS
-    [MELODY_OH_TANNENBAUM] = {75, 150, 9},  // Oh_Tannenbaum
-    [MELODY_OH_DU_FROHLICHE] = {85, 170, 8},  // Oh_du_frohliche
-    [MELODY_SCHNEEFLOCKCHEN_WEISSROCKCHEN] = {75, 140, 7},  // Schneeflockchen_Weissrockchen
-    [MELODY_STILLE_NACHT_CHIPVERSION] = {75, 150, 8},  // Stille_Nacht_ChipVersion
-    [MELODY_THE_FIRST_NOEL_TRUMPET_ONLY] = {80, 140, 8},  // The_First_Noel_Trumpet_only
-    [MELODY_KOMMET_IHR_HIRTEN] = {80, 160, 4},  // kommet-ihr-hirten
-    [MELODY_TRADITIONAL_MUSIC_I_SAW_THREE_SHIPS_COME_SAILING_IN] = {75, 150, 9},  // traditional-music-i-saw-three-ships-come-sailing-in
+    [MELODY_JINGLE_BELLS] = {85, 180, -1},  // JINGLE_BELLS
+    [MELODY_OH_TANNENBAUM] = {75, 150, 2},  // Oh_Tannenbaum
+    [MELODY_OH_DU_FROHLICHE] = {85, 170, 1},  // Oh_du_frohliche
+    [MELODY_SCHNEEFLOCKCHEN_WEISSROCKCHEN] = {75, 140, 0},  // Schneeflockchen_Weissrockchen
+    [MELODY_STILLE_NACHT_CHIPVERSION] = {75, 150, 1},  // Stille_Nacht_ChipVersion
+    [MELODY_THE_FIRST_NOEL_TRUMPET_ONLY] = {80, 140, 1},  // The_First_Noel_Trumpet_only
+    [MELODY_KOMMET_IHR_HIRTEN] = {80, 160, -3},  // kommet-ihr-hirten
+    [MELODY_TRADITIONAL_MUSIC_I_SAW_THREE_SHIPS_COME_SAILING_IN] = {75, 150, 2},  // traditional-music-i-saw-three-ships-come-sailing-in
     [MELODY_TEST_TONE] = {80, 100, 0},  // Test tone
 };
 
 // ============================================================================
-// ENABLED SONGS LIST - From config.yaml (enabled by default)
+// ENABLED SONGS LIST - From config.yaml (enabled by default, by priority while flash lasts)
 // ============================================================================
 
 #if ENABLE_SONG_ROTATION
@@ -343,48 +404,35 @@ const uint8_t ENABLED_SONG_COUNT = 7;
 // ACCESSOR FUNCTIONS
 // ============================================================================
 
-const audio_note_t *get_melody_data(melody_id_t melody_id, uint8_t *note_count)
+const audio_song_t *get_melody_data(melody_id_t melody_id)
 {
     switch (melody_id) {
     case MELODY_JINGLE_BELLS:
-        *note_count = sizeof(melody_jingle_bells) / sizeof(audio_note_t);
-        return melody_jingle_bells;
+        return &melody_jingle_bells;
 
     case MELODY_OH_TANNENBAUM:
-        *note_count = sizeof(melody_oh_tannenbaum) / sizeof(audio_note_t);
-        return melody_oh_tannenbaum;
+        return &melody_oh_tannenbaum;
 
     case MELODY_OH_DU_FROHLICHE:
-        *note_count = sizeof(melody_oh_du_frohliche) / sizeof(audio_note_t);
-        return melody_oh_du_frohliche;
+        return &melody_oh_du_frohliche;
 
     case MELODY_SCHNEEFLOCKCHEN_WEISSROCKCHEN:
-        *note_count = sizeof(melody_schneeflockchen_weissrockchen) / sizeof(audio_note_t);
-        return melody_schneeflockchen_weissrockchen;
+        return &melody_schneeflockchen_weissrockchen;
 
     case MELODY_STILLE_NACHT_CHIPVERSION:
-        *note_count = sizeof(melody_stille_nacht_chipversion) / sizeof(audio_note_t);
-        return melody_stille_nacht_chipversion;
+        return &melody_stille_nacht_chipversion;
 
     case MELODY_THE_FIRST_NOEL_TRUMPET_ONLY:
-        *note_count = sizeof(melody_the_first_noel_trumpet_only) / sizeof(audio_note_t);
-        return melody_the_first_noel_trumpet_only;
+        return &melody_the_first_noel_trumpet_only;
 
     case MELODY_KOMMET_IHR_HIRTEN:
-        *note_count = sizeof(melody_kommet_ihr_hirten) / sizeof(audio_note_t);
-        return melody_kommet_ihr_hirten;
-
-    case MELODY_TRADITIONAL_MUSIC_I_SAW_THREE_SHIPS_COME_SAILING_IN:
-        *note_count = sizeof(melody_traditional_music_i_saw_three_ships_come_sailing_in) / sizeof(audio_note_t);
-        return melody_traditional_music_i_saw_three_ships_come_sailing_in;
+        return &melody_kommet_ihr_hirten;
 
     case MELODY_TEST_TONE:
-        *note_count = sizeof(melody_test_tone) / sizeof(audio_note_t);
-        return melody_test_tone;
+        return &melody_test_tone;
 
     case MELODY_NONE:
     default:
-        *note_count = 0;
         return NULL;
     }
 }
@@ -13,8 +13,9 @@
 #define AUDIO_SONGS_GENERATED_H_
 
 #include <stdint.h>
+#include <avr/pgmspace.h>
 
-// Note: This file is included from audio.h AFTER audio_note_t and song_config_t are defined
+// Note: This file is included from audio.h AFTER audio_song_t and song_config_t are defined
 // Do not include audio.h here to avoid circular dependency
 
 // ============================================================================
@@ -40,9 +41,19 @@ typedef enum
 // FUNCTION DECLARATIONS
 // ============================================================================
 
-const audio_note_t *get_melody_data(melody_id_t melody_id, uint8_t *note_count);
+const audio_song_t *get_melody_data(melody_id_t melody_id); // PROGMEM descriptor (NULL for none)
 const song_config_t *get_song_config(melody_id_t melody_id);
 
+// Timer1 setting and DDS phase step per pitch index (PROGMEM)
+extern const audio_pitch_timer_t audio_pitch_timers[] PROGMEM;
+#if FEATURE_AUDIO_DDS
+extern const uint16_t audio_pitch_dds_steps[] PROGMEM;
+#endif
+
+// Shared phrase segments referenced by AUDIO_PITCH_SEGMENT codes (PROGMEM)
+extern const uint8_t audio_segment_notes[] PROGMEM;
+extern const uint16_t audio_segment_offsets[] PROGMEM;
+
 // ============================================================================
 // ENABLED SONGS DECLARATIONS
 // ============================================================================
@@ -7,37 +7,288 @@
  */
 
 #include "hardware.h"
-#include <string.h>
 #include <avr/eeprom.h>
+#include <avr/sleep.h>
+#include "../Profiler/profiler.h"
+
+#if FEATURE_LED_HW_PWM && FEATURE_LED_BAM_PWM
+#error "FEATURE_LED_BAM_PWM needs Timer0 compare B as slice timer - disable FEATURE_LED_HW_PWM"
+#endif
+
+#if FEATURE_AUDIO_DDS && FEATURE_LED_HW_PWM
+#error "FEATURE_AUDIO_DDS and FEATURE_LED_HW_PWM both need a 31.25kHz ISR, too little CPU is left - disable one"
+#endif
+
+#if TELEM_ENABLED && FEATURE_LED_BAM_PWM
+#error "Telemetry bits are paced by the fixed software PWM step - disable FEATURE_LED_BAM_PWM"
+#endif
+
+#if FEATURE_LED_HW_PWM
+// Hardware PWM timing: Timer0 runs fast PWM at CK/1 (TOP = 0xFF, 31.25kHz) driving
+// OC0A/OC0B directly. The overflow interrupt is the software PWM step for PB2/PB3 and
+// advances millis with fractional accumulation (same scheme as Arduino's millis()).
+#define TIMER0_OVF_MICROS ((256UL * 1000000UL) / F_CPU) // 32us per overflow at 8MHz
+#define MILLIS_INC (TIMER0_OVF_MICROS / 1000)            // Whole milliseconds per overflow
+#define FRACT_INC ((TIMER0_OVF_MICROS % 1000) >> 3)      // Remaining microseconds / 8 (fits in a byte)
+#define FRACT_MAX (1000 >> 3)
+
+// Software PWM only covers the rings that are not on OC0A/OC0B (PB2 is the telemetry TX line)
+#if TELEM_ENABLED
+#define SOFT_PWM_PIN_MASK (1 << PIN_LED_3ER)
+#else
+#define SOFT_PWM_PIN_MASK ((1 << PIN_LED_3ER) | (1 << PIN_LED_4ER))
+#endif
+#else
+// Software PWM timing: Timer0 runs CTC with 125 counts of 8us per 1ms millis tick.
+// Compare channel B revolves inside that period and fires every PWM_TICK_COUNTS counts,
+// giving a fixed PWM step independent of how long the main loop takes.
+#define TIMER0_CTC_TOP 124 // OCR0A = (8,000,000 / (64 * 1000)) - 1
+
+#if FEATURE_LED_BAM_PWM
+// Bit-angle modulation: 8 binary weighted slices per frame instead of 256 compare steps.
+// Slice n lasts BAM_UNIT_COUNTS << n timer counts; slices longer than one Timer0 period
+// are split into chunks of at most BAM_MAX_STEP_COUNTS so the revolving compare can reach them.
+#define BAM_UNIT_COUNTS 2                  // 2 * 8us = 16us LSB slice (128 CPU cycles ISR headroom)
+#define BAM_MAX_STEP_COUNTS TIMER0_CTC_TOP // Longest single compare step inside the 125-count period
+                                           // Frame = 255 * 16us = 4.08ms (~245Hz refresh), 11 interrupts
+#else
+#define PWM_TICK_COUNTS 5  // 5 * 8us = 40us per PWM step -> 256-step frame = 10.24ms (~98Hz refresh)
+
+#if ((TIMER0_CTC_TOP + 1) % PWM_TICK_COUNTS) != 0
+#error "PWM_TICK_COUNTS must divide the Timer0 period evenly"
+#endif
+#endif
+
+#if TELEM_ENABLED
+#define SOFT_PWM_PIN_MASK ((1 << PIN_LED_1ER) | (1 << PIN_LED_3ER) | (1 << PIN_LED_5ER))
+#else
+#define SOFT_PWM_PIN_MASK ((1 << PIN_LED_1ER) | (1 << PIN_LED_3ER) | (1 << PIN_LED_4ER) | (1 << PIN_LED_5ER))
+#endif
+#endif
 
 // PRIVATE VARIABLES
 static bool hardware_initialized = false;
 static volatile uint32_t g_millis_counter = 0;
-static uint8_t led_brightness_active[LED_COUNT_MAX] = {0};
-static uint8_t led_brightness_pending[LED_COUNT_MAX] = {0};
+static uint8_t led_brightness_active[LED_COUNT_MAX] = {0};           // Owned by the PWM ISR
+static volatile uint8_t led_brightness_pending[LED_COUNT_MAX] = {0}; // Published by the main loop
 static volatile bool buffer_swap_pending = false;
-static volatile uint8_t pwm_counter = 0;
+static uint8_t pwm_counter = 0;                                       // Owned by the PWM ISR
 static const uint8_t led_pins[LED_COUNT_MAX] = {PIN_LED_1ER, PIN_LED_3ER, PIN_LED_4ER, PIN_LED_5ER};
 
+#if FEATURE_LED_HW_PWM
+static uint8_t g_millis_fract = 0; // Sub-millisecond remainder in 8us units (overflow ISR only)
+#if PROF_ENABLED || TELEM_ENABLED
+static volatile uint8_t g_timer0_overflows = 0; // High byte of the profiler cycle stamp
+#endif
+#endif
+
+#if FEATURE_LED_BAM_PWM
+// BAM engine state - owned by the PWM ISR, planes rebuilt at the double-buffer swap
+static uint8_t bam_plane_mask[8] = {0}; // PORTB LED bits for each bit plane
+static uint8_t bam_plane = 0;           // Current bit plane (counts down 7..0)
+static uint16_t bam_remaining = 0;      // Timer counts left in the current slice
+#endif
+
+#if !FEATURE_LED_BAM_PWM
+// Software PWM kernel: per-frame edge schedule compiled at the double-buffer swap
+typedef struct
+{
+    uint8_t tick;          // PWM counter value at which this edge fires (0 = end of list)
+    uint8_t port_off_mask; // PORTB LED bits switched off at this edge
+    uint8_t flags;         // PWM_EDGE_* actions
+} pwm_edge_t;
+
+#define PWM_EDGE_MIC_WINDOW 0x01 // PB3 switches to input - microphone sampling window opens
+
+#if FEATURE_LED_HW_PWM && TELEM_ENABLED
+static const uint8_t soft_pwm_rings[] = {LED_3ER_RING};
+#elif FEATURE_LED_HW_PWM
+static const uint8_t soft_pwm_rings[] = {LED_3ER_RING, LED_4ER_RING};
+#elif TELEM_ENABLED
+static const uint8_t soft_pwm_rings[] = {LED_1ER_RING, LED_3ER_RING, LED_5ER_RING}; // LED_4ER pin is the TX line
+#else
+static const uint8_t soft_pwm_rings[] = {LED_1ER_RING, LED_3ER_RING, LED_4ER_RING, LED_5ER_RING};
+#endif
+
+static pwm_edge_t pwm_edges[sizeof(soft_pwm_rings) + 1] = {{0, 0, 0}}; // Sorted by tick + sentinel
+static uint8_t pwm_frame_on_mask = 0;  // PORTB LED bits switched on at tick 0
+static uint8_t pwm_edge_index = 0;     // Next edge to fire
+static uint8_t pwm_next_edge_tick = 0; // Cached pwm_edges[pwm_edge_index].tick
+#endif
+
 #ifndef RESET_PIN_AS_IO
 // DEBUG BUILD: Microphone sampling during PWM LOW periods
-static volatile bool mic_reading_ready = false;    // True when safe to read ADC
+static volatile bool mic_reading_ready = false;    // True while PB3 is an input (LED_3ER dark)
+#endif
+
+#if (MIC_ADC_RING_SIZE & (MIC_ADC_RING_SIZE - 1)) != 0
+#error "MIC_ADC_RING_SIZE must be a power of two"
+#endif
+
+// Microphone sample queue - single producer (ADC ISR), single consumer (main loop)
+static volatile uint16_t mic_ring[MIC_ADC_RING_SIZE];
+static volatile uint8_t mic_ring_head = 0; // Written by the ADC ISR only
+static volatile uint8_t mic_ring_tail = 0; // Written by the main loop only
+static volatile uint16_t mic_last_sample = 0;
+#if FEATURE_MICROPHONE_SENSOR && !FEATURE_MIC_ADC_NOISE_REDUCTION
+static uint16_t mic_accum = 0;             // Oversampling accumulator (ISR only)
+static uint8_t mic_accum_count = 0;
+#endif
+
+#if FEATURE_MIC_ADC_NOISE_REDUCTION
+// Single conversions started from the main loop (no auto trigger)
+static volatile bool mic_quiet_done = false;
+static uint16_t mic_stall_us = 0; // Timer0 time lost in ADC noise reduction sleep, not yet credited to millis
+#define MIC_ADC_AUTO_TRIGGER 0
+#else
+#define MIC_ADC_AUTO_TRIGGER (1 << ADATE)
+#endif
+
+// ADC trigger source follows the PWM step: overflow in hardware PWM mode, compare B otherwise
+#if FEATURE_LED_HW_PWM
+#define MIC_ADC_TRIGGER_SOURCE (1 << ADTS2)               // Timer/Counter0 overflow
+#else
+#define MIC_ADC_TRIGGER_SOURCE ((1 << ADTS2) | (1 << ADTS0)) // Timer/Counter0 compare match B
+#endif
+
+#ifndef RESET_PIN_AS_IO
+// DEBUG BUILD: PB3 becomes the microphone input - arm ADC auto-trigger for the window
+// ADCSRA is written without ADIF (writing 1 would clear a pending conversion-complete flag)
+static inline void mic_window_open(void)
+{
+    DDRB &= ~(1 << SHARED_PIN_MIC_LED); // Switch to input
+    mic_reading_ready = true;
+#if FEATURE_MICROPHONE_SENSOR && !FEATURE_MIC_ADC_NOISE_REDUCTION
+    ADCSRA = (ADCSRA & ~(1 << ADIF)) | (1 << ADATE);
+#endif
+}
+
+// DEBUG BUILD: PB3 drives LED_3ER again - stop triggering and drop the partial average
+static inline void mic_window_close(void)
+{
+    DDRB |= (1 << SHARED_PIN_MIC_LED); // Switch to output
+    mic_reading_ready = false;
+#if FEATURE_MICROPHONE_SENSOR && !FEATURE_MIC_ADC_NOISE_REDUCTION
+    ADCSRA &= ~((1 << ADIF) | (1 << ADATE));
+    mic_accum = 0;
+    mic_accum_count = 0;
+#endif
+}
+#endif
+
+#if TELEM_ENABLED
+// ============================================================================
+// TELEMETRY SOFT UART
+// ============================================================================
+
+#if (TELEMETRY_TX_BUFFER_SIZE & (TELEMETRY_TX_BUFFER_SIZE - 1)) != 0
+#error "TELEMETRY_TX_BUFFER_SIZE must be a power of two"
+#endif
+
+// Byte queue - single producer (main loop), single consumer (PWM ISR)
+static volatile uint8_t telemetry_ring[TELEMETRY_TX_BUFFER_SIZE]; // volatile keeps the byte stores ahead of the head store
+static volatile uint8_t telemetry_head = 0; // Written by the main loop only
+static volatile uint8_t telemetry_tail = 0; // Written by the PWM ISR only
+static uint16_t telemetry_shift = 0;        // Data bits then the stop bit, LSB first (ISR only)
+static uint8_t telemetry_bits = 0;          // Bits of the current byte still to send, 0 = between bytes
+
+// One bit time per PWM step - first thing in the ISR, so the edges keep a fixed latency
+static inline void telemetry_tx_tick(void)
+{
+    if (telemetry_bits == 0)
+    {
+        uint8_t tail = telemetry_tail;
+        if (tail == telemetry_head)
+        {
+            return; // Line idles HIGH
+        }
+        telemetry_shift = telemetry_ring[tail] | 0x100; // Stop bit after the 8 data bits
+        telemetry_tail = (tail + 1) & (TELEMETRY_TX_BUFFER_SIZE - 1);
+        telemetry_bits = 9;
+        PORTB &= ~(1 << PIN_TELEMETRY_TX); // Start bit
+        return;
+    }
+
+    if (telemetry_shift & 1)
+        PORTB |= (1 << PIN_TELEMETRY_TX);
+    else
+        PORTB &= ~(1 << PIN_TELEMETRY_TX);
+    telemetry_shift >>= 1;
+    telemetry_bits--;
+}
+
+bool hardware_telemetry_write(const uint8_t *data, uint8_t length)
+{
+    uint8_t head = telemetry_head;
+    uint8_t used = (head - telemetry_tail) & (TELEMETRY_TX_BUFFER_SIZE - 1);
+    if (length > TELEMETRY_TX_BUFFER_SIZE - 1 - used)
+    {
+        return false; // Whole frames only - the decoder sees the gap in the sequence number
+    }
+
+    for (uint8_t i = 0; i < length; i++)
+    {
+        telemetry_ring[head] = data[i];
+        head = (head + 1) & (TELEMETRY_TX_BUFFER_SIZE - 1);
+    }
+    telemetry_head = head; // Publish after the bytes are in place
+    return true;
+}
 #endif
 
 // ============================================================================
 // TIMER INTERRUPT FOR MILLIS COUNTER
 // ============================================================================
 
+#if !FEATURE_LED_HW_PWM
 // Timer0 compare match interrupt - 1ms tick
 ISR(TIMER0_COMPA_vect) // ATtiny85 uses TIMER0_COMPA_vect
 {
     g_millis_counter++;
 }
+#endif
 
 // ============================================================================
 // HARDWARE INITIALIZATION
 // ============================================================================
 
+// Start Timer0 in the configured PWM engine mode (boot and standby wake-up)
+static void hardware_timer0_start(void)
+{
+#if FEATURE_LED_HW_PWM
+    // Timer0 fast PWM mode (TOP = 0xFF) at CK/1 - OC0A (PB0) and OC0B (PB1) driven in hardware
+    // Compare outputs are connected per ring by hw_pwm_load() (disconnected while brightness is 0)
+    TCCR0A = (1 << WGM01) | (1 << WGM00); // Fast PWM, COM0A1:0=00, COM0B1:0=00 until first frame
+    TCCR0B = (1 << CS00);                // No prescaler - 31.25kHz PWM
+    OCR0A = 0;
+    OCR0B = 0;
+
+    // Overflow drives millis and the software PWM step for PB2/PB3
+    TIMSK |= (1 << TOIE0);
+#else
+    // Timer0 CTC mode for 1ms interrupt - needed for lighting effects timing
+    // IMPORTANT: Ensure Compare Output modes are disabled to allow normal I/O on PB0/PB1
+    TCCR0A = (1 << WGM01);              // CTC mode, COM0A1:0=00, COM0B1:0=00 (normal I/O)
+    TCCR0B = (1 << CS01) | (1 << CS00); // Prescaler 64
+
+    // Calculate OCR0A for 1ms interrupt based on CPU frequency
+    
+    // ATtiny85: 8MHz CPU, prescaler 64, target 1000Hz
+    // OCR0A = (8,000,000 / (64 * 1000)) - 1 = 124
+    OCR0A = TIMER0_CTC_TOP;
+
+    // Compare B drives the software PWM step (revolving compare point, see TIMER0_COMPB_vect)
+#if FEATURE_LED_BAM_PWM
+    OCR0B = BAM_UNIT_COUNTS; // First slice boundary, the ISR schedules all following ones
+#else
+    OCR0B = PWM_TICK_COUNTS - 1;
+#endif
+
+    // Enable Timer Compare A (millis) and B (LED PWM)
+    TIMSK |= (1 << OCIE0A) | (1 << OCIE0B); // ATtiny85 uses TIMSK 
+#endif
+}
+
 void hardware_init(void)
 {
     sei();
@@ -47,12 +298,19 @@ void hardware_init(void)
     CLKPR = (1 << CLKPCE); // Enable clock prescaler change
     CLKPR = 0;             // Set prescaler to 1 (no division) = 8MHz
 
+    // Power down unused peripherals: USI clock gated, analog comparator off
+    PRR = (1 << PRUSI);
+    ACSR |= (1 << ACD);
+
 
     // DEBUG BUILD: Initialize regular LED pins as outputs (exclude shared pin PB3/LED_3ER)
     DDRB |= (1 << PIN_LED_1ER) | (1 << PIN_LED_4ER) | (1 << PIN_LED_5ER);
     // Note: PIN_LED_3ER (PB3) starts as output, switched to input during dark windows
     DDRB |= (1 << SHARED_PIN_MIC_LED);   // Start PB3 as output for LED
     PORTB &= ~(1 << SHARED_PIN_MIC_LED); // Ensure LOW initially
+#if TELEM_ENABLED
+    PORTB |= (1 << PIN_TELEMETRY_TX);    // UART idle level (LED_4ER pin, left out of the PWM engine)
+#endif
 
 
 #if FEATURE_MICROPHONE_SENSOR
@@ -60,103 +318,274 @@ void hardware_init(void)
     hardware_microphone_init();
 #endif
 
-    // Restore Timer0 to 1ms tick for timing system
+    // Timer0: millis and LED PWM
+    hardware_timer0_start();
 
-    // Timer0 CTC mode for 1ms interrupt - needed for lighting effects timing
-    // IMPORTANT: Ensure Compare Output modes are disabled to allow normal I/O on PB0/PB1
-    TCCR0A = (1 << WGM01);              // CTC mode, COM0A1:0=00, COM0B1:0=00 (normal I/O)
-    TCCR0B = (1 << CS01) | (1 << CS00); // Prescaler 64
+    sei();
 
-    // Calculate OCR0A for 1ms interrupt based on CPU frequency
-    
-    // ATtiny85: 8MHz CPU, prescaler 64, target 1000Hz
-    // OCR0A = (8,000,000 / (64 * 1000)) - 1 = 124
-    OCR0A = 124;
 
-    // Enable Timer Compare 
-    TIMSK |= (1 << OCIE0A); // ATtiny85 uses TIMSK 
+    hardware_initialized = true;
+}
+
+#if FEATURE_LED_HW_PWM
+// Load the hardware PWM rings from the active buffer (OCR0A/OCR0B are double-buffered at TOP)
+// Brightness 0 disconnects the compare output - fast PWM would otherwise still emit a 1-clock spike
+static inline void hw_pwm_load(void)
+{
+    uint8_t tccr0a = TCCR0A & ~((1 << COM0A1) | (1 << COM0A0) | (1 << COM0B1) | (1 << COM0B0));
 
-    sei();
+    OCR0A = led_brightness_active[LED_1ER_RING];
+    if (led_brightness_active[LED_1ER_RING])
+        tccr0a |= (1 << COM0A1); // Non-inverting: set at BOTTOM, clear on compare match
 
+    OCR0B = led_brightness_active[LED_5ER_RING];
+    if (led_brightness_active[LED_5ER_RING])
+        tccr0a |= (1 << COM0B1);
 
-    hardware_initialized = true;
+    TCCR0A = tccr0a;
 }
+#endif
 
-void hardware_update(void)
+#if FEATURE_LED_BAM_PWM
+// Precompute one PORTB mask per bit plane from the active brightness buffer
+static void bam_build_planes(void)
 {
-    pwm_counter++; // Automatic rollover at 256 (uint8_t)
+    for (uint8_t plane = 0; plane < 8; plane++)
+    {
+        uint8_t bit = (1 << plane);
+        uint8_t mask = 0;
+
+        if (led_brightness_active[LED_1ER_RING] & bit)
+            mask |= (1 << PIN_LED_1ER);
+        if (led_brightness_active[LED_3ER_RING] & bit)
+            mask |= (1 << PIN_LED_3ER);
+        if (led_brightness_active[LED_4ER_RING] & bit)
+            mask |= (1 << PIN_LED_4ER);
+        if (led_brightness_active[LED_5ER_RING] & bit)
+            mask |= (1 << PIN_LED_5ER);
+
+        bam_plane_mask[plane] = mask;
+    }
+}
 
-    // Double buffer: Swap buffers at start of PWM cycle to avoid glitches
-    if (pwm_counter == 0 && buffer_swap_pending)
+// Timer0 compare B interrupt - start the next BAM slice (or the next chunk of a long slice)
+ISR(TIMER0_COMPB_vect)
+{
+    if (bam_remaining == 0)
     {
-        // Safe to swap at PWM cycle boundary (all LEDs just turned off)
-        memcpy(led_brightness_active, led_brightness_pending, LED_COUNT_MAX);
-        buffer_swap_pending = false;
+        if (bam_plane == 0)
+        {
+            // Frame boundary: planes run 7..0, so the next one is the MSB
+            bam_plane = 8;
+
+            // Double buffer: Swap buffers at start of BAM frame to avoid glitches
+            if (buffer_swap_pending)
+            {
+                for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+                {
+                    led_brightness_active[i] = led_brightness_pending[i];
+                }
+                buffer_swap_pending = false;
+                bam_build_planes();
+            }
+        }
+        bam_plane--;
+
+        uint8_t plane_mask = bam_plane_mask[bam_plane];
+
+#ifndef RESET_PIN_AS_IO
+        // DEBUG BUILD: PB3 is an output only in planes where LED_3ER is lit,
+        // all other slices are microphone sampling windows
+        if (plane_mask & (1 << SHARED_PIN_MIC_LED))
+        {
+            mic_window_close();
+        }
+        else if (!mic_reading_ready)
+        {
+            mic_window_open();
+        }
+#endif
+
+        // Update LEDs while preserving buzzer pin
+        PORTB = (PORTB & ~SOFT_PWM_PIN_MASK) | plane_mask;
+
+        bam_remaining = (uint16_t)BAM_UNIT_COUNTS << bam_plane;
     }
 
+    // Schedule the end of this slice (or chunk) on the revolving compare point
+    uint8_t step = (bam_remaining > BAM_MAX_STEP_COUNTS) ? BAM_MAX_STEP_COUNTS : (uint8_t)bam_remaining;
+    bam_remaining -= step;
+
+    uint8_t next_compare = OCR0B + step;
+    if (next_compare > TIMER0_CTC_TOP)
+    {
+        next_compare -= (TIMER0_CTC_TOP + 1);
+    }
+    OCR0B = next_compare;
+}
+#else
+// Compile the active buffer into this frame's edge schedule (once per double-buffer swap)
+// Rings switch on at tick 0 and off at tick == brightness; rings sharing a value share one edge
+static void pwm_compile_edges(void)
+{
+    uint8_t edge_count = 0;
+    uint8_t on_mask = 0;
+
+    for (uint8_t r = 0; r < sizeof(soft_pwm_rings); r++)
+    {
+        uint8_t ring = soft_pwm_rings[r];
+        uint8_t tick = led_brightness_active[ring];
+        if (tick == 0)
+        {
+            continue; // Off for the whole frame - no edge needed
+        }
+
+        uint8_t pin_mask = (1 << led_pins[ring]);
+        uint8_t flags = 0;
 #ifndef RESET_PIN_AS_IO
-    // DEBUG BUILD: Sample microphone during PWM LOW periods of LED_3ER
-    // This allows very frequent sampling without visible LED disruption
-    
-    // Check if LED_3ER is in its LOW phase (PWM counter > brightness)
-    if (pwm_counter > led_brightness_active[LED_3ER_RING])
+        if (ring == LED_3ER_RING)
+        {
+            flags = PWM_EDGE_MIC_WINDOW; // PB3 becomes a microphone input at this edge
+        }
+#endif
+        on_mask |= pin_mask;
+
+        // Merge into an existing edge with the same tick, otherwise insert sorted
+        uint8_t i = 0;
+        while (i < edge_count && pwm_edges[i].tick < tick)
+        {
+            i++;
+        }
+        if (i < edge_count && pwm_edges[i].tick == tick)
+        {
+            pwm_edges[i].port_off_mask |= pin_mask;
+            pwm_edges[i].flags |= flags;
+            continue;
+        }
+        for (uint8_t j = edge_count; j > i; j--)
+        {
+            pwm_edges[j] = pwm_edges[j - 1];
+        }
+        pwm_edges[i].tick = tick;
+        pwm_edges[i].port_off_mask = pin_mask;
+        pwm_edges[i].flags = flags;
+        edge_count++;
+    }
+
+    pwm_edges[edge_count].tick = 0; // Sentinel - next match is the frame start at tick 0
+    pwm_frame_on_mask = on_mask;
+}
+
+// One software PWM step - called from the Timer0 PWM ISR (compare B, or overflow in hardware PWM mode)
+// Hot path is a single compare against the next precompiled edge
+static inline void pwm_tick(void)
+{
+    pwm_counter++; // Automatic rollover at 256 (uint8_t)
+
+    if (pwm_counter != pwm_next_edge_tick)
+    {
+        return;
+    }
+
+    if (pwm_counter == 0)
     {
-        // LED_3ER is naturally OFF during this part of PWM cycle
-        // Switch PB3 to INPUT for ADC sampling
-        if (DDRB & (1 << SHARED_PIN_MIC_LED))
+        // Frame start - double buffer: Swap buffers at start of PWM cycle to avoid glitches
+        if (buffer_swap_pending)
         {
-            DDRB &= ~(1 << SHARED_PIN_MIC_LED); // Switch to input
+            for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+            {
+                led_brightness_active[i] = led_brightness_pending[i];
+            }
+            buffer_swap_pending = false;
+            pwm_compile_edges();
+#if FEATURE_LED_HW_PWM
+            hw_pwm_load();
+#endif
+        }
+
+#ifndef RESET_PIN_AS_IO
+        // DEBUG BUILD: PB3 is an LED output until LED_3ER's edge, then a microphone input
+        if (pwm_frame_on_mask & (1 << SHARED_PIN_MIC_LED))
+        {
+            mic_window_close();
         }
-        
-        // Every MIC_SAMPLE_INTERVAL PWM cycles during LOW phase, set ready flag
-        if ((pwm_counter % MIC_SAMPLE_INTERVAL_MIN) == 0)
+        else if (!mic_reading_ready)
         {
-            mic_reading_ready = true;
+            mic_window_open(); // LED_3ER dark all frame - input throughout
         }
+#endif
+
+        // Switch on every lit ring while preserving buzzer pin
+        PORTB = (PORTB & ~SOFT_PWM_PIN_MASK) | pwm_frame_on_mask;
+        pwm_edge_index = 0;
     }
     else
     {
-        // LED_3ER is in HIGH phase - need PB3 as OUTPUT
-        if (!(DDRB & (1 << SHARED_PIN_MIC_LED)))
+        const pwm_edge_t *edge = &pwm_edges[pwm_edge_index++];
+        PORTB &= ~edge->port_off_mask;
+
+#ifndef RESET_PIN_AS_IO
+        // DEBUG BUILD: LED_3ER is naturally OFF for the rest of the frame - sample microphone
+        if (edge->flags & PWM_EDGE_MIC_WINDOW)
         {
-            DDRB |= (1 << SHARED_PIN_MIC_LED); // Switch to output
+            mic_window_open();
         }
-        mic_reading_ready = false;
+#endif
     }
-    
-    // Update LED PWM - preserve BUZZER_PIN (PB4) and handle PB3 separately
-    uint8_t port_state = PORTB & ~((1 << PIN_LED_1ER) | (1 << PIN_LED_4ER) | (1 << PIN_LED_5ER) | (1 << SHARED_PIN_MIC_LED));
-
-    // Set regular LED pins high if brightness > PWM counter
-    if (led_brightness_active[LED_1ER_RING] > pwm_counter)
-        port_state |= (1 << PIN_LED_1ER);
-    if (led_brightness_active[LED_4ER_RING] > pwm_counter)
-        port_state |= (1 << PIN_LED_4ER);
-    if (led_brightness_active[LED_5ER_RING] > pwm_counter)
-        port_state |= (1 << PIN_LED_5ER);
-    
-    // LED_3ER (PB3): Set HIGH only if in its HIGH phase of PWM cycle
-    if (led_brightness_active[LED_3ER_RING] > pwm_counter)
-        port_state |= (1 << SHARED_PIN_MIC_LED);
 
-#else
-    // PRODUCTION BUILD: Simple PWM for all LEDs
-    uint8_t port_state = PORTB & ~((1 << PIN_LED_1ER) | (1 << PIN_LED_3ER) | (1 << PIN_LED_4ER) | (1 << PIN_LED_5ER));
+    pwm_next_edge_tick = pwm_edges[pwm_edge_index].tick;
+}
+
+#endif // FEATURE_LED_BAM_PWM
 
-    if (led_brightness_active[LED_1ER_RING] > pwm_counter)
-        port_state |= (1 << PIN_LED_1ER);
-    if (led_brightness_active[LED_3ER_RING] > pwm_counter)
-        port_state |= (1 << PIN_LED_3ER);
-    if (led_brightness_active[LED_4ER_RING] > pwm_counter)
-        port_state |= (1 << PIN_LED_4ER);
-    if (led_brightness_active[LED_5ER_RING] > pwm_counter)
-        port_state |= (1 << PIN_LED_5ER);
+#if FEATURE_LED_HW_PWM
+// Timer0 overflow interrupt - every 256 CPU cycles (32us)
+ISR(TIMER0_OVF_vect)
+{
+    // Fractional millis accumulation: 32us per overflow never adds a whole ms on its own
+    uint32_t millis_value = g_millis_counter + MILLIS_INC;
+    uint8_t fract = g_millis_fract + FRACT_INC;
+    if (fract >= FRACT_MAX)
+    {
+        fract -= FRACT_MAX;
+        millis_value++;
+    }
+    g_millis_fract = fract;
+    g_millis_counter = millis_value;
+#if PROF_ENABLED || TELEM_ENABLED
+    g_timer0_overflows++;
+#endif
+#if TELEM_ENABLED
+    telemetry_tx_tick();
+#endif
+
+    PROF_BEGIN(PROF_PWM_ISR);
+    pwm_tick();
+    PROF_END(PROF_PWM_ISR);
+}
+#elif !FEATURE_LED_BAM_PWM
+// Timer0 compare B interrupt - fixed-rate software PWM step
+ISR(TIMER0_COMPB_vect)
+{
+#if TELEM_ENABLED
+    telemetry_tx_tick();
 #endif
 
-    // Update LEDs while preserving buzzer pin
-    PORTB = port_state;
+    // Move the compare point PWM_TICK_COUNTS ahead, wrapping inside the CTC period
+    uint8_t next_compare = OCR0B + PWM_TICK_COUNTS;
+    if (next_compare > TIMER0_CTC_TOP)
+    {
+        next_compare -= (TIMER0_CTC_TOP + 1);
+    }
+    OCR0B = next_compare;
+
+    PROF_BEGIN(PROF_PWM_ISR);
+    pwm_tick();
+    PROF_END(PROF_PWM_ISR);
+}
+#endif
 
-} // ============================================================================
+// ============================================================================
 // LED CONTROL FUNCTIONS
 // ============================================================================
 
@@ -172,19 +601,44 @@ void hardware_led_set(led_id_t led, uint8_t brightness)
     buffer_swap_pending = true; // Signal that new values are ready
 }
 
+void hardware_led_commit(const uint8_t frame[LED_COUNT_MAX])
+{
+    // Withdraw the pending frame while it is rewritten - a frame start in between keeps showing
+    // the previous frame, so the ISR swaps either none or all of the rings
+    buffer_swap_pending = false;
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        led_brightness_pending[i] = frame[i];
+    }
+    buffer_swap_pending = true;
+}
+
 void hardware_led_all_off(void)
 {
+    cli(); // PWM ISR owns the active buffer
     PORTB &= ~((1 << PIN_LED_1ER) | (1 << PIN_LED_3ER) | (1 << PIN_LED_5ER));
-    memset(led_brightness_active, 0, sizeof(led_brightness_active));
-    memset(led_brightness_pending, 0, sizeof(led_brightness_pending));
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        led_brightness_active[i] = 0;
+        led_brightness_pending[i] = 0;
+    }
     buffer_swap_pending = false;
+#if FEATURE_LED_HW_PWM
+    hw_pwm_load(); // Disconnects OC0A/OC0B
+#endif
+#if FEATURE_LED_BAM_PWM
+    bam_build_planes();
+#else
+    pwm_compile_edges();
+#endif
+    sei();
 }
 
 
 void hardware_init_pwm(void)
 {
     // Only set buzzer pin as output, do not configure Timer0 for PWM
-    DDRB |= (1 << BUZZER_PIN);   // PB4 as output for bit-banging
+    DDRB |= (1 << BUZZER_PIN);   // PB4 as output (Timer1 OC1B tone output)
     PORTB &= ~(1 << BUZZER_PIN); // Ensure buzzer starts LOW to prevent noise
 }
 
@@ -200,106 +654,386 @@ uint32_t hardware_get_millis(void)
     return millis_copy;
 }
 
+#if PROF_ENABLED || TELEM_ENABLED
+uint16_t hardware_get_cycle_stamp(void)
+{
+    uint8_t sreg = SREG; // Also called from inside the PWM ISR
+    cli();
+#if FEATURE_LED_HW_PWM
+    uint8_t count = TCNT0;
+    uint8_t high = g_timer0_overflows;
+    if ((TIFR & (1 << TOV0)) && count < 0xFF)
+    {
+        high++; // Overflow pending, count already wrapped
+    }
+    uint16_t stamp = ((uint16_t)high << 8) | count;
+#else
+    uint8_t count = TCNT0;
+    uint16_t ms = (uint16_t)g_millis_counter;
+    if ((TIFR & (1 << OCF0A)) && count < TIMER0_CTC_TOP)
+    {
+        ms++; // Compare match pending, count already wrapped
+    }
+    uint16_t stamp = ms * (TIMER0_CTC_TOP + 1) + count;
+#endif
+    SREG = sreg;
+    return stamp;
+}
+#endif
+
+uint16_t hardware_get_ticks(void)
+{
+    // Low half of the counter (AVR is little-endian). The ISRs only add to it, so a read torn by
+    // a carry between the two bytes never matches the re-read - retry instead of blocking the ISR
+    const volatile uint16_t *ticks = (const volatile uint16_t *)&g_millis_counter;
+    uint16_t value;
+    do
+    {
+        value = *ticks;
+    } while (value != *ticks);
+    return value;
+}
+
+uint8_t hardware_get_ticks8(void)
+{
+    return *(const volatile uint8_t *)&g_millis_counter; // Single byte load - always atomic
+}
+
 
 // ============================================================================
 // MICROPHONE SENSOR (ADC)
 // ============================================================================
 
+// Configure the ADC for interrupt-driven microphone sampling (init and standby wake-up)
+static void mic_adc_start(void)
+{
+    // Configure ADC for microphone input on PB3 (ADC3)
+    // Use internal 1.1V reference for stable operation regardless of battery voltage
+    ADMUX = (1 << REFS1) | (1 << MUX1) | (1 << MUX0); // 1.1V internal reference, ADC3 (PB3)
+    ADCSRB = MIC_ADC_TRIGGER_SOURCE;                  // Conversions start on the Timer0 PWM step
+
+    // Enable ADC with conversion-complete interrupt, prescaler 64 (125kHz ADC clock, ~108us per conversion)
+    // Auto trigger (ADATE) runs while PB3 is an input - debug builds disarm it while LED_3ER is lit
+    // (noise reduction mode starts single conversions from hardware_microphone_sample_quiet() instead)
+    ADCSRA = (1 << ADEN) | (1 << ADIE) | MIC_ADC_AUTO_TRIGGER | (1 << ADPS2) | (1 << ADPS1);
+#ifndef RESET_PIN_AS_IO
+    mic_reading_ready = true; // PB3 is an input - the next frame start re-evaluates the window
+#endif
+}
+
 void hardware_microphone_init(void)
 {
     // DEBUG BUILD: Configure PB3 (shared pin) as ADC input for microphone
     DDRB &= ~(1 << SHARED_PIN_MIC_LED);  // PB3 as input for ADC
     PORTB &= ~(1 << SHARED_PIN_MIC_LED); // Disable pull-up (required for ADC input)
 
-    // Configure ADC for microphone input on PB3 (ADC3)
-    // Use internal 1.1V reference for stable operation regardless of battery voltage
-    ADMUX = (1 << REFS1) | (1 << MUX1) | (1 << MUX0);                  // 1.1V internal reference, ADC3 (PB3)
-    ADCSRA = (1 << ADEN) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0); // Enable ADC, prescaler 128 for stable readings
+    // No settling delay: the 1.1V reference is up within the first conversion (same as the standby wake-up),
+    // and the baseline tracker absorbs an off first sample
+    mic_adc_start();
+}
 
-    // Allow ADC to settle with new reference
-    _delay_ms(10);
+#if FEATURE_MIC_ADC_NOISE_REDUCTION
+// ADC conversion complete - wakes the CPU from hardware_microphone_sample_quiet()
+ISR(ADC_vect)
+{
+    mic_last_sample = ADC;
+    mic_quiet_done = true;
+    SIM_MARK_ADC_SAMPLE();
 }
 
-uint16_t hardware_microphone_read(void)
+bool hardware_microphone_sample_quiet(uint16_t *sample)
 {
 #ifndef RESET_PIN_AS_IO
-    // DEBUG BUILD: Wait for sampling opportunity during PWM LOW period
-    uint8_t timeout = 50;
-    while (!mic_reading_ready && timeout > 0)
+    if (!mic_reading_ready)
     {
-        _delay_us(2);
-        timeout--;
+        return false; // LED_3ER is driving PB3
     }
-    
-    // Clear flag immediately to wait for next sampling opportunity
-    mic_reading_ready = false;
 #endif
 
-    // PB3 is input during LOW periods (debug) or permanently (production)
-    _delay_us(5); // Brief settling delay
+    mic_quiet_done = false;
 
-    // Single ADC conversion
-    ADCSRA |= (1 << ADSC);
-    while (ADCSRA & (1 << ADSC))
+    if (TCCR1 & ((1 << CS13) | (1 << CS12) | (1 << CS11) | (1 << CS10)))
     {
-        // Wait for conversion complete
+        // Tone running: Timer1 would stall in noise reduction sleep - convert with the CPU idle instead
+        ADCSRA |= (1 << ADSC);
+        set_sleep_mode(SLEEP_MODE_IDLE);
     }
+    else
+    {
+        // Entering ADC noise reduction mode starts the conversion
+        set_sleep_mode(SLEEP_MODE_ADC);
 
-    uint16_t result = ADC;
-    return result;
-}
+        // Timer0 stops with clkIO - credit the stalled time to millis in whole milliseconds
+        cli();
+        mic_stall_us += MIC_ADC_NR_STALL_US;
+        if (mic_stall_us >= 1000)
+        {
+            mic_stall_us -= 1000;
+            g_millis_counter++;
+        }
+        sei();
+    }
 
-uint16_t hardware_microphone_read_filtered(void)
+    // Any other interrupt (PWM step in idle mode) wakes the CPU early - sleep again until done
+    sleep_enable();
+    while (!mic_quiet_done)
+    {
+        sleep_cpu();
+    }
+    sleep_disable();
+
+    *sample = mic_last_sample;
+    return true;
+}
+#elif FEATURE_MICROPHONE_SENSOR
+// ADC conversion complete - average MIC_ADC_OVERSAMPLE_SHIFT conversions into one queued sample
+ISR(ADC_vect)
 {
-    // Simple averaging filter - keep sampling fast to minimize LED disruption
-    uint32_t sum = 0;
-    const uint8_t samples = 8;
+    uint16_t value = ADC;
+
+#ifndef RESET_PIN_AS_IO
+    if (!mic_reading_ready)
+    {
+        return; // Window closed during the conversion - PB3 may already drive LED_3ER
+    }
+#endif
+    SIM_MARK_ADC_SAMPLE();
 
-    for (uint8_t i = 0; i < samples; i++)
+    mic_accum += value;
+    if (++mic_accum_count < (1 << MIC_ADC_OVERSAMPLE_SHIFT))
     {
-        sum += hardware_microphone_read();
-        _delay_us(50); // Reduced delay - faster sampling
+        return;
     }
 
-    return (uint16_t)(sum / samples);
+    uint16_t sample = mic_accum >> MIC_ADC_OVERSAMPLE_SHIFT;
+    mic_accum = 0;
+    mic_accum_count = 0;
+    mic_last_sample = sample;
+
+    // Queue full: drop the new sample, the consumer still has older ones pending
+    uint8_t head = mic_ring_head;
+    uint8_t next = (head + 1) & (MIC_ADC_RING_SIZE - 1);
+    if (next != mic_ring_tail)
+    {
+        mic_ring[head] = sample;
+        mic_ring_head = next;
+    }
+}
+#endif
+
+bool hardware_microphone_pop(uint16_t *sample)
+{
+    uint8_t tail = mic_ring_tail;
+    if (tail == mic_ring_head)
+    {
+        return false;
+    }
+
+    // The ISR never writes this slot before the tail moves past it
+    *sample = mic_ring[tail];
+    mic_ring_tail = (tail + 1) & (MIC_ADC_RING_SIZE - 1);
+    return true;
+}
+
+uint16_t hardware_microphone_read(void)
+{
+    PROF_BEGIN(PROF_MIC_READ);
+    uint16_t sample;
+    cli(); // 16-bit value written by the ADC ISR
+    sample = mic_last_sample;
+    sei();
+    PROF_END(PROF_MIC_READ);
+    return sample;
 }
 
 // ============================================================================
-// AUDIO OUTPUT (PWM)
+// AUDIO OUTPUT (Timer1 PWM on OC1B/PB4)
 // ============================================================================
 
-void hardware_audio_set_frequency(uint16_t frequency)
+void hardware_audio_init(void)
 {
+    TCCR1 = 0;                                                    // Timer1 stopped (CS13:0 = 0000)
+    GTCCR &= ~((1 << PWM1B) | (1 << COM1B1) | (1 << COM1B0));     // OC1B disconnected
+    DDRB |= (1 << BUZZER_PIN);                                    // PB4 as output
+    PORTB &= ~(1 << BUZZER_PIN);                                  // Ensure buzzer starts LOW to prevent noise
+}
+
+void hardware_audio_set_timer(uint8_t clock_select, uint8_t top, uint8_t compare)
+{
+    if (clock_select == 0)
+    {
+        hardware_audio_stop(); // Rest
+        return;
+    }
 
-    (void)frequency; // Suppress unused parameter warning for full audio system
-    // For full audio system: use bit-banging like simple audio
-    // Hardware PWM doesn't work well for low audio frequencies
-    // We'll just store the frequency and let audio system handle the bit-banging
+    // Timer1 PWM mode B: counts 0..OCR1C, OC1B set at BOTTOM and cleared at OCR1B
+    // Prescaler and top come from the generated audio_pitch_timers[], so no division here
+    TCCR1 = 0; // Stop Timer1 while reprogramming
+    TCNT1 = 0;
+    OCR1C = top;
+    OCR1B = compare;
 
-    // No hardware setup needed - audio.cpp will handle the bit-banging
-    // Just ensure the pin is set as output
+    // PWM1B + COM1B1:0 = 10: only OC1B (PB4) is driven, ~OC1B (PB3 = microphone) stays disconnected
+    GTCCR = (GTCCR & ~((1 << COM1B0))) | (1 << PWM1B) | (1 << COM1B1);
     DDRB |= (1 << BUZZER_PIN);
+    TCCR1 = clock_select; // Start Timer1 - tone now runs without CPU involvement
+}
+
+void hardware_audio_stop(void)
+{
+#if FEATURE_AUDIO_DDS
+    TIMSK &= ~(1 << TOIE1); // No DDS samples while Timer1 is stopped
+#endif
+    TCCR1 = 0;                                                // Stop Timer1 clock
+    GTCCR &= ~((1 << PWM1B) | (1 << COM1B1) | (1 << COM1B0)); // Give PB4 back to PORTB
+    PORTB &= ~(1 << BUZZER_PIN);
+}
+
+
+#if FEATURE_AUDIO_DDS
+// Sample ISR state - 16-bit writes from the main loop go through cli/sei
+static volatile uint16_t dds_phase[AUDIO_DDS_VOICES];
+static volatile uint16_t dds_step[AUDIO_DDS_VOICES];
+static volatile uint8_t dds_duty = 0;  // Pulse width as phase high byte (duty in 1/256)
+static volatile uint8_t dds_level = 0; // OCR1B contribution of a voice in its high phase
+
+void hardware_audio_dds_start(uint8_t duty_scale, uint8_t voices)
+{
+    TCCR1 = 0;
+    TCNT1 = 0;
+    dds_duty = duty_scale;
+    dds_level = (voices > 1) ? 127 : 255; // Full swing for a lone melody, two voices share it
+    for (uint8_t voice = 0; voice < AUDIO_DDS_VOICES; voice++)
+    {
+        dds_step[voice] = 0;
+        dds_phase[voice] = 0xFFFF; // Silent, the first step wraps into the high phase
+    }
 
-    // The actual tone generation will be handled in the audio_update() function
-    // using the same proven bit-banging approach as audio_simple_play_tone_timed()
+    // Same PWM1B/COM1B1 setup as the square tone, TOP fixed at 255 for 8-bit samples
+    // CK/1 instead of the 64MHz PLL clock: the carrier must equal the sample rate the ISR can
+    // keep up with, and at 31.25kHz PCK/8 would only add the PLL current and its lock time
+    OCR1C = 255;
+    OCR1B = 0;
+    GTCCR = (GTCCR & ~((1 << COM1B0))) | (1 << PWM1B) | (1 << COM1B1);
+    DDRB |= (1 << BUZZER_PIN);
+    TIFR = (1 << TOV1);
+    TIMSK |= (1 << TOIE1);
+    TCCR1 = (1 << CS10);
 }
 
-void hardware_audio_stop(void) { 
-    PORTB &= ~(1 << BUZZER_PIN); 
+void hardware_audio_dds_voice(uint8_t voice, uint16_t phase_step)
+{
+    cli();
+    dds_step[voice] = phase_step;
+    if (phase_step == 0)
+    {
+        dds_phase[voice] = 0xFFFF; // Park in the low phase - no contribution until the next note
+    }
+    sei();
 }
 
+// One sample per Timer1 period: advance both phases, output the sum of their pulse waves
+// OCR1B is double-buffered at TOP, so the new level always starts with a full carrier period
+ISR(TIMER1_OVF_vect)
+{
+    PROF_BEGIN(PROF_DDS_ISR);
+    uint8_t level = dds_level;
+    uint8_t duty = dds_duty;
+    uint8_t sample = 0;
+
+    uint16_t phase = dds_phase[0] + dds_step[0];
+    dds_phase[0] = phase;
+    if ((uint8_t)(phase >> 8) < duty)
+    {
+        sample = level;
+    }
+
+    phase = dds_phase[1] + dds_step[1];
+    dds_phase[1] = phase;
+    if ((uint8_t)(phase >> 8) < duty)
+    {
+        sample += level;
+    }
+
+    OCR1B = sample;
+    PROF_END(PROF_DDS_ISR);
+}
+#endif
 
 // ============================================================================
 // EEPROM STORAGE (Persistent storage across resets)
 // ============================================================================
 
+// Queued writes, one per EE_READY interrupt - the main loop never waits for the ~3.4ms cell write
+static uint16_t eeprom_queue_address[EEPROM_WRITE_QUEUE_SIZE];
+static uint8_t eeprom_queue_data[EEPROM_WRITE_QUEUE_SIZE];
+static volatile uint8_t eeprom_queue_head = 0;
+static volatile uint8_t eeprom_queue_count = 0;
+
+// Fires whenever EERIE is set and no write is in progress
+ISR(EE_RDY_vect)
+{
+    while (eeprom_queue_count > 0)
+    {
+        uint8_t head = eeprom_queue_head;
+        eeprom_queue_head = (head + 1 < EEPROM_WRITE_QUEUE_SIZE) ? head + 1 : 0;
+        eeprom_queue_count--;
+
+        EEAR = eeprom_queue_address[head];
+        EECR |= (1 << EERE);
+        if (EEDR == eeprom_queue_data[head])
+        {
+            continue; // Unchanged bytes are skipped, no wear
+        }
+
+        // Atomic erase + write (EEPM1:0 = 00): EEMPE, then EEPE within 4 cycles
+        EEDR = eeprom_queue_data[head];
+        EECR = (1 << EERIE) | (1 << EEMPE);
+        EECR |= (1 << EEPE);
+        return;
+    }
+
+    EECR &= ~(1 << EERIE); // Queue empty and the last write done
+}
+
+// Wait for queued writes - direct EEPROM access must not interleave with the ISR
+static void eeprom_queue_flush(void)
+{
+    while (EECR & ((1 << EERIE) | (1 << EEPE)))
+    {
+        // Needs interrupts enabled, ~3.4ms per queued byte
+    }
+}
+
+bool hardware_eeprom_write_queued(uint16_t address, uint8_t data)
+{
+    uint8_t sreg = SREG;
+    cli();
+    bool queued = eeprom_queue_count < EEPROM_WRITE_QUEUE_SIZE;
+    if (queued)
+    {
+        uint8_t tail = eeprom_queue_head + eeprom_queue_count;
+        if (tail >= EEPROM_WRITE_QUEUE_SIZE)
+            tail -= EEPROM_WRITE_QUEUE_SIZE;
+        eeprom_queue_address[tail] = address;
+        eeprom_queue_data[tail] = data;
+        eeprom_queue_count++;
+        EECR |= (1 << EERIE); // The ISR starts right away when the EEPROM is idle
+    }
+    SREG = sreg;
+    return queued;
+}
+
 uint8_t hardware_eeprom_read_byte(uint16_t address)
 {
+    eeprom_queue_flush();
     return eeprom_read_byte((uint8_t *)address);
 }
 
 void hardware_eeprom_write_byte(uint16_t address, uint8_t data)
 {
+    eeprom_queue_flush();
+
     // Only write if the data is different to preserve EEPROM life
     uint8_t current_value = eeprom_read_byte((uint8_t *)address);
     if (current_value != data)
@@ -307,3 +1041,103 @@ void hardware_eeprom_write_byte(uint16_t address, uint8_t data)
         eeprom_write_byte((uint8_t *)address, data);
     }
 }
+
+// ============================================================================
+// POWER MANAGEMENT
+// ============================================================================
+
+void hardware_idle(void)
+{
+#if POWER_MEASUREMENT_BUSY_LOOP
+    _delay_us(10); // Reference build: the former busy-wait between loop iterations
+#else
+    // Timers and ADC keep running in IDLE - any of their interrupts wakes the CPU
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_enable();
+    sleep_cpu();
+    sleep_disable();
+#endif
+}
+
+#if STANDBY_TIMEOUT_S > 0 && FEATURE_MICROPHONE_SENSOR
+// Watchdog interrupt - standby sniff timer, only used to wake from power-down
+ISR(WDT_vect)
+{
+}
+
+// Average of a few polled conversions on the microphone (ADC otherwise off in standby)
+static uint16_t standby_sniff(void)
+{
+    ADCSRA = (1 << ADEN) | (1 << ADPS2) | (1 << ADPS1); // No interrupt, no auto trigger
+
+    uint16_t sum = 0;
+    for (uint8_t i = 0; i <= STANDBY_SNIFF_SAMPLES; i++)
+    {
+        ADCSRA |= (1 << ADSC);
+        while (ADCSRA & (1 << ADSC))
+        {
+            // ~108us, first conversion after enabling ~200us (reference start-up)
+        }
+        if (i > 0)
+        {
+            sum += ADC; // First conversion after enabling is discarded
+        }
+    }
+
+    ADCSRA = 0; // ADC off until the next sniff
+    return sum / STANDBY_SNIFF_SAMPLES;
+}
+
+// Watchdog periodic interrupt on (no reset) or off - timed WDCE sequence
+static void standby_watchdog(uint8_t wdtcr)
+{
+    cli();
+    MCUSR &= ~(1 << WDRF);
+    WDTCR = (1 << WDCE) | (1 << WDE);
+    WDTCR = wdtcr;
+    sei();
+}
+
+void hardware_standby(uint16_t wake_level)
+{
+    eeprom_queue_flush(); // EE_READY cannot run in power-down, finish queued writes first
+
+    // LEDs and buzzer off, then stop Timer0 (PWM + millis) and the ADC
+    hardware_audio_stop();
+    hardware_led_all_off();
+    TIMSK &= ~((1 << OCIE0A) | (1 << OCIE0B) | (1 << TOIE0));
+    TCCR0B = 0;
+    TCCR0A = 0;
+    ADCSRA = 0;
+
+    // PB3 stays a microphone input while asleep
+    DDRB &= ~(1 << SHARED_PIN_MIC_LED);
+    PORTB &= ~SOFT_PWM_PIN_MASK;
+
+    // Power-down with a watchdog sniff: the analog comparator cannot wake the CPU from power-down,
+    // and pin change needs a digital level the peak detector never reaches
+    standby_watchdog((1 << WDIE) | STANDBY_WDT_PRESCALER);
+
+    uint32_t slept_ms = 0;
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    do
+    {
+        sleep_enable();
+        sleep_bod_disable(); // BOD off while asleep (timed sequence right before sleep)
+        sleep_cpu();
+        sleep_disable();
+        slept_ms += STANDBY_SNIFF_MS;
+    } while (standby_sniff() <= wake_level);
+
+    standby_watchdog(0);
+
+    // Timer0 was stopped - credit the nominal sleep time so cooldowns and effects keep their meaning
+    cli();
+    g_millis_counter += slept_ms;
+    sei();
+
+    // Back to normal operation: Timer0 PWM/millis and interrupt-driven microphone sampling
+    hardware_timer0_start();
+    mic_adc_start();
+}
+#endif
@@ -36,10 +36,10 @@ extern "C"
 
     // Hardware initialization
     void hardware_init(void);
-    void hardware_update(void);
 
     // LED Functions
-    void hardware_led_set(led_id_t led, uint8_t brightness);
+    void hardware_led_set(led_id_t led, uint8_t brightness);        // One ring, shown from the next PWM frame
+    void hardware_led_commit(const uint8_t frame[LED_COUNT_MAX]);   // All rings at once (indexed by led_id_t) - never a torn frame
     void hardware_led_all_off(void);
 
     // PWM Functions for LED brightness control
@@ -49,29 +49,113 @@ extern "C"
     // TIMING FUNCTIONS
     // ============================================================================
 
-    uint32_t hardware_get_millis(void);
+    uint32_t hardware_get_millis(void); // Full 32-bit millis (interrupts briefly off) - cooldown, standby
+
+    // Coarse 1ms ticks: low bits of the millis counter, read without disabling interrupts
+    // The 16-bit tick wraps every 65.5s - only for intervals shorter than that
+    uint16_t hardware_get_ticks(void);
+    uint8_t hardware_get_ticks8(void);
+
+    // Wrap-safe interval helpers on 16-bit ticks
+    static inline uint16_t hardware_ticks_elapsed(uint16_t since)
+    {
+        return (uint16_t)(hardware_get_ticks() - since);
+    }
+
+    static inline bool hardware_ticks_expired(uint16_t since, uint16_t interval)
+    {
+        return hardware_ticks_elapsed(since) >= interval;
+    }
+
+#if PROF_ENABLED || TELEM_ENABLED
+    // Free-running Timer0 stamp for the profiler and the telemetry loop load, wraps at 16 bits
+    // CTC/BAM: Timer0 clocks at CK/64 (64 cycles each), HW PWM: CPU cycles
+#if FEATURE_LED_HW_PWM
+#define HARDWARE_STAMP_CYCLES 1
+#else
+#define HARDWARE_STAMP_CYCLES 64
+#endif
+    uint16_t hardware_get_cycle_stamp(void);
+#endif
+
+    // ============================================================================
+    // POWER MANAGEMENT
+    // ============================================================================
+
+    void hardware_idle(void); // Sleep (IDLE) until the next interrupt - PWM step, ADC or millis tick
+#if STANDBY_TIMEOUT_S > 0 && FEATURE_MICROPHONE_SENSOR
+    void hardware_standby(uint16_t wake_level); // Power down until a watchdog sniff reads the mic above wake_level
+#endif
 
     // ============================================================================
     // MICROPHONE SENSOR (ADC)
     // ============================================================================
 
     void hardware_microphone_init(void);
-    uint16_t hardware_microphone_read(void);
-    uint16_t hardware_microphone_read_filtered(void);
+    bool hardware_microphone_pop(uint16_t *sample); // Next queued sample from the ADC ISR (false = none pending)
+    uint16_t hardware_microphone_read(void);        // Most recent sample (non-blocking)
+#if FEATURE_MIC_ADC_NOISE_REDUCTION
+    bool hardware_microphone_sample_quiet(uint16_t *sample); // One conversion with the CPU asleep (false = PB3 not an input)
+#endif
 
     // ============================================================================
-    // AUDIO OUTPUT (PWM)
+    // AUDIO OUTPUT (Timer1 PWM on OC1B/PB4)
     // ============================================================================
 
-    void hardware_audio_set_frequency(uint16_t frequency);
-    void hardware_audio_stop(void);
+    // f_tone = F_CPU / (2^(clock_select - 1) * (top + 1)), OC1B high for compare of the top + 1 counts
+    void hardware_audio_init(void);                                                  // Buzzer pin output LOW, Timer1 stopped
+    void hardware_audio_set_timer(uint8_t clock_select, uint8_t top, uint8_t compare); // Start tone (clock_select 0 = stop), runs in hardware
+    void hardware_audio_stop(void);                                                   // Stop Timer1 and release PB4 LOW
+
+#if FEATURE_AUDIO_DDS
+    // Two-voice DDS: Timer1 PWM at CK/1 (31.25kHz carrier on OC1B), the overflow ISR is the sample clock.
+    // Each voice is a 16-bit phase accumulator read as a pulse wave; OCR1B = sum of the voices.
+    // The ISR is meant to stay well under the 256 cycles per sample (measure with PROF_DDS_ISR in the
+    // attiny85_profile_dds env) so LED PWM steps and ADC conversions keep their slots - a late sample
+    // just repeats the previous level. Not combinable with FEATURE_LED_HW_PWM (second 31.25kHz ISR).
+#define AUDIO_DDS_SAMPLE_RATE (F_CPU / 256) // 31.25kHz at 8MHz, phase step = Hz * 65536 / AUDIO_DDS_SAMPLE_RATE
+#define AUDIO_DDS_VOICES 2
+    void hardware_audio_dds_start(uint8_t duty_scale, uint8_t voices); // Start the sample ISR, both voices silent (duty in 1/256)
+    void hardware_audio_dds_voice(uint8_t voice, uint16_t phase_step);  // Phase step of a voice, 0 = silent
+#endif
 
     // ============================================================================
     // EEPROM STORAGE (Persistent storage across resets)
     // ============================================================================
 
     uint8_t hardware_eeprom_read_byte(uint16_t address);
-    void hardware_eeprom_write_byte(uint16_t address, uint8_t data);
+    void hardware_eeprom_write_byte(uint16_t address, uint8_t data);         // Blocks ~3.4ms per changed byte (queue drained first)
+    bool hardware_eeprom_write_queued(uint16_t address, uint8_t data);      // Written from the EE_READY ISR, in order (false = queue full)
+
+#if TELEM_ENABLED
+    // ============================================================================
+    // TELEMETRY SOFT UART (TX only on PIN_TELEMETRY_TX, 8N1)
+    // ============================================================================
+
+    // One bit per software PWM step from the Timer0 PWM ISR - no extra timer, never blocks
+#if FEATURE_LED_HW_PWM
+#define HARDWARE_TELEMETRY_BAUD (F_CPU / 256)      // Overflow ISR: 31250 baud at 8MHz
+#else
+#define HARDWARE_TELEMETRY_BAUD (F_CPU / 64 / 5)   // Compare B ISR every PWM_TICK_COUNTS: 25000 baud at 8MHz
+#endif
+    bool hardware_telemetry_write(const uint8_t *data, uint8_t length); // Queue all bytes or none (false = no room)
+#endif
+
+    // ============================================================================
+    // SIMULATION TRACE MARKERS (simavr VCD, see src/sim_trace.c)
+    // ============================================================================
+
+#if SIMULATION_MODE
+#define SIM_MARK_LOOP_BUSY() (GPIOR0 = 1)       // Scheduler pass running tasks
+#define SIM_MARK_LOOP_IDLE() (GPIOR0 = 0)       // Scheduler pass done, sleeping until the next deadline
+#define SIM_MARK_MELODY(id) (GPIOR1 = (id))     // melody_id_t now playing (MELODY_NONE = sequence done)
+#define SIM_MARK_ADC_SAMPLE() (GPIOR2++)        // One microphone conversion taken on PB3
+#else
+#define SIM_MARK_LOOP_BUSY()
+#define SIM_MARK_LOOP_IDLE()
+#define SIM_MARK_MELODY(id)
+#define SIM_MARK_ADC_SAMPLE()
+#endif
 
 #ifdef __cplusplus
 }
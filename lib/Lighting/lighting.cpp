@@ -6,14 +6,16 @@
  * https://creativecommons.org/licenses/by-nc/4.0/
  *
  * Feature-configurable LED effects system
- * Uses config.h feature flags to control compilation
+ * The effects enabled in config.yaml form a flash registry, cycled at runtime
  */
 
 #include "lighting.h"
 #include <string.h>
+#include <avr/pgmspace.h>
 #include "../../config/config.h"
 #include "../Sensors/sensors.h"
 #include "../Hardware/hardware.h"
+#include "../Scheduler/scheduler.h"
 #if FEATURE_AUDIO_OUTPUT
 #include "../Audio/audio.h"
 #endif
@@ -26,100 +28,489 @@ typedef struct
 {
     bool initialized;
     lighting_effect_t current_effect;
-    uint32_t last_update_time;
+    uint8_t effect_slot; // lighting_effects[] entry of current_effect, LIGHTING_EFFECT_SLOT_NONE outside the registry
     uint8_t effect_speed;
-    uint8_t led_states[LED_COUNT_MAX];
-    uint16_t effect_counter;
-    uint8_t candle_intensity_boost; // 0-100 additional intensity from microphone
+    uint16_t effect_counter; // lighting_update() frames of the current effect
+
+    // Compositor layers (lighting_compose), indexed by led_id_t
+    uint8_t base_layer[LED_COUNT_MAX]; // Output of the current effect (or the startup sequence)
+    uint8_t breath_boost;              // 0-100 breath boost layer from the microphone
+    bool layers_muted;                 // Base and boost hidden - the audio-reactive overlay owns the rings
+    bool layers_dirty;                 // A layer changed since the last commit
+    uint16_t candle_wave_phase[LED_COUNT_MAX]; // Per-ring medium wave, Q8 (integer part = effect ms / wave divider)
+    uint16_t random_state;                     // xorshift16 state (never 0)
+
+    // Candle keyframe interpolation (lighting_interpolate)
+    uint8_t candle_target[LED_COUNT_MAX];    // Brightness computed by the last candle frame
+    uint16_t candle_level_q8[LED_COUNT_MAX]; // Brightness shown, Q8
+    int16_t candle_step_q8[LED_COUNT_MAX];   // Slew per LIGHTING_SLEW_MS, Q8
+
+    // Breathing effect
+    uint8_t breathing_level;  // 0-205 above the 50 floor
+    bool breathing_rising;
+
+    // Startup effect (lighting_interpolate)
+    lighting_effect_t startup_next_effect; // Effect resumed when the sequence ends
+    uint8_t startup_step;                  // Next entry of startup_steps[]
+    uint16_t startup_time;                 // hardware_get_ticks() when the sequence started
+
+    // Audio-reactive envelopes (lighting_interpolate during songs), indexed by led_id_t
+    uint16_t envelope_level_q8[LED_COUNT_MAX]; // Brightness shown, Q8
+    uint8_t envelope_peak[LED_COUNT_MAX];      // Attack target of the ring's last note
+    uint8_t envelope_attack_mask;              // Rings still attacking or holding their peak (bit = led_id_t)
+    uint16_t envelope_time;                    // hardware_get_ticks() of the last envelope step
 } lighting_state_t;
 
 static lighting_state_t g_lighting_state;
 
 // ============================================================================
-// PRIVATE HELPER FUNCTIONS
+// LAYER COMPOSITOR
 // ============================================================================
 
-// Batch LED update removed - using direct hardware_led_set calls for simplicity
+// Q8 weights folded at compile time, rounded up so exact ratios (boost * 4/5) land on the integer a division gives
+#define LAYER_Q 8
+#define LAYER_COEF(num, den) ((uint16_t)((((uint32_t)(num) << LAYER_Q) + (den) - 1) / (den)))
 
+typedef struct
+{
+    uint16_t boost_gain; // Q8 weight of the breath boost (0-100)
+    uint8_t ceiling;     // The boost stops here - also the candle's upper clamp
+} layer_ring_t;
+
+// Boost 0-100 maps to 80/70/60/40 extra brightness, tip to base (indexed by led_id_t)
+static const layer_ring_t layer_rings[LED_COUNT_MAX] PROGMEM = {
+    {LAYER_COEF(4, 5), 180},  // LED_1ER_RING (TIP)
+    {LAYER_COEF(7, 10), 140}, // LED_3ER_RING (UPPER)
+    {LAYER_COEF(3, 5), 100},  // LED_4ER_RING (MIDDLE)
+    {LAYER_COEF(2, 5), 70},   // LED_5ER_RING (BASE)
+};
+
+#if FEATURE_CANDLE_EFFECT
 // ============================================================================
-// PUBLIC FUNCTIONS
+// CANDLE RING DESCRIPTORS
 // ============================================================================
 
-bool lighting_init(void)
+// Candle flicker coefficients, folded from the config constants at compile time (Q8 fixed point)
+// A frame is then table reads, adds, shifts and small multiplies - no software division
+#define CANDLE_Q LAYER_Q
+#define CANDLE_COEF(num, den) LAYER_COEF(num, den)
+#define CANDLE_FLICKER(mul, den) CANDLE_COEF((mul) * CANDLE_FLICKER_INTENSITY, (den))
+#define CANDLE_BASE(pct) ((uint8_t)((LED_BRIGHTNESS_DEFAULT * (pct)) / 100))
+#define CANDLE_WAVE_STEP(div) ((uint16_t)(((uint32_t)LIGHTING_FRAME_MS << 8) / (div))) // Wraps harmlessly - only the low bits are used
+#define CANDLE_SLEW(levels_per_ms) ((uint16_t)((levels_per_ms) * 256))                   // Q8 slew limit
+
+// Slews spread a keyframe change over the frame: delta * 256 / slew steps as a Q16 reciprocal multiply
+#define CANDLE_SLEW_STEPS (LIGHTING_FRAME_MS / LIGHTING_SLEW_MS)
+#define CANDLE_SLEW_RECIP ((uint16_t)(65536UL / CANDLE_SLEW_STEPS))
+
+typedef struct
 {
-    // Initialize lighting state to default values
-    g_lighting_state.current_effect = LIGHTING_EFFECT_NONE;
-    g_lighting_state.effect_counter = 0;
-    g_lighting_state.last_update_time = 0;
-    g_lighting_state.candle_intensity_boost = 0; // Initialize microphone boost
+    uint8_t led;          // led_id_t
+    uint8_t base;         // LED_BRIGHTNESS_DEFAULT share of the ring
+    uint8_t seed_offset;  // Per-ring decorrelation of the shared random seed
+    uint8_t flicker_mul;  // Fast flicker = ((seed + offset) * mul) & mask, centered at mask / 2
+    uint8_t flicker_mask;
+    uint8_t wave_mask;    // Medium wave = triangle of the phase integer part, centered at mask / 4
+    uint16_t wave_step;   // Phase advance per frame, Q8
+    uint16_t k_flicker;   // Q8 weights of the fast, medium and slow components
+    uint16_t k_wave;
+    uint16_t k_slow;
+    uint8_t gust;         // Dip on a wind gust
+    uint16_t slew_max;    // Fastest brightness change per LIGHTING_SLEW_MS, Q8 (tip lively, base lazy)
+} candle_ring_t;
+
+// Tip flickers most, base is a gentle glow - different behavior per ring level (ATtiny85+)
+static const candle_ring_t candle_rings[LED_COUNT_MAX] PROGMEM = {
+    // LED_1ER_RING (TIP) - Maximum flicker, most dramatic
+    {LED_1ER_RING, CANDLE_BASE(CANDLE_TIP_BRIGHTNESS_PCT), 7, 5, 0x3F, 0x1F, CANDLE_WAVE_STEP(1),
+     CANDLE_FLICKER(1, 100), CANDLE_FLICKER(3, 100), CANDLE_FLICKER(1, 200),
+     (30 * CANDLE_FLICKER_INTENSITY) / 100, CANDLE_SLEW(2)},
+    // LED_3ER_RING (UPPER) - High flicker, second most active
+    {LED_3ER_RING, CANDLE_BASE(CANDLE_UPPER_BRIGHTNESS_PCT), 13, 3, 0x1F, 0x1F, CANDLE_WAVE_STEP(2),
+     CANDLE_FLICKER(1, 100), CANDLE_FLICKER(2, 100), CANDLE_FLICKER(1, 300),
+     (25 * CANDLE_FLICKER_INTENSITY) / 100, CANDLE_SLEW(1)},
+    // LED_4ER_RING (MIDDLE) - Medium flicker, more stable
+    {LED_4ER_RING, CANDLE_BASE(CANDLE_MIDDLE_BRIGHTNESS_PCT), 19, 2, 0x0F, 0x0F, CANDLE_WAVE_STEP(3),
+     CANDLE_FLICKER(1, 100), CANDLE_FLICKER(2, 100), CANDLE_FLICKER(1, 400),
+     (20 * CANDLE_FLICKER_INTENSITY) / 100, CANDLE_SLEW(0.5)},
+    // LED_5ER_RING (BASE) - Gentle glow, most stable
+    {LED_5ER_RING, CANDLE_BASE(CANDLE_BASE_BRIGHTNESS_PCT), 23, 1, 0x07, 0x07, CANDLE_WAVE_STEP(6),
+     CANDLE_FLICKER(2, 100), CANDLE_FLICKER(2, 100), CANDLE_FLICKER(1, 600),
+     (12 * CANDLE_FLICKER_INTENSITY) / 100, CANDLE_SLEW(0.25)},
+};
+
+// Per-ring medium wave start phases (the former effect_counter offsets)
+static const uint8_t candle_wave_offsets[LED_COUNT_MAX] PROGMEM = {3, 7, 11, 0};
+#endif
+
+// ============================================================================
+// STARTUP SEQUENCE
+// ============================================================================
 
-    // Initialize all LED states to off
+// Bottom to top build-up, then a dark pause - rings lit at STARTUP_BUILDUP_BRIGHTNESS from at_ms on
+typedef struct
+{
+    uint16_t at_ms;    // Offset from lighting_startup_animation()
+    uint8_t ring_mask; // Lit rings (bit = led_id_t), STARTUP_END finishes the sequence
+} startup_step_t;
+
+#define STARTUP_END 0xFF
+#define STARTUP_RING(ring) (1 << (ring))
+#define STARTUP_STEP_AT(n) (STARTUP_LEAD_IN_MS + (n) * STARTUP_STEP_DELAY_MS)
+
+static const startup_step_t startup_steps[] PROGMEM = {
+    {STARTUP_STEP_AT(0), STARTUP_RING(LED_5ER_RING)},
+    {STARTUP_STEP_AT(1), STARTUP_RING(LED_5ER_RING) | STARTUP_RING(LED_4ER_RING)},
+    {STARTUP_STEP_AT(2), STARTUP_RING(LED_5ER_RING) | STARTUP_RING(LED_4ER_RING) | STARTUP_RING(LED_3ER_RING)},
+    {STARTUP_STEP_AT(3), STARTUP_RING(LED_5ER_RING) | STARTUP_RING(LED_4ER_RING) | STARTUP_RING(LED_3ER_RING) | STARTUP_RING(LED_1ER_RING)},
+    {STARTUP_STEP_AT(4), 0},                                       // Dramatic pause
+    {STARTUP_STEP_AT(4) + STARTUP_DARK_PAUSE_MS, STARTUP_END},     // ~730ms in total
+};
+
+// ============================================================================
+// PRIVATE HELPER FUNCTIONS
+// ============================================================================
+
+#if FEATURE_CANDLE_EFFECT
+// xorshift16 (7, 9, 8) - period 65535, a few shifts and XORs per call
+static uint16_t lighting_random(void)
+{
+    uint16_t x = g_lighting_state.random_state;
+    x ^= x << 7;
+    x ^= x >> 9;
+    x ^= x << 8;
+    g_lighting_state.random_state = x;
+    return x;
+}
+
+// Signed component * Q8 weight, truncated toward zero like the integer division it replaces
+static int16_t candle_scale(int8_t value, uint16_t weight)
+{
+    int16_t product = (int16_t)value * (int16_t)weight;
+    if (product < 0)
+        product += (1 << CANDLE_Q) - 1;
+    return product >> CANDLE_Q;
+}
+
+// One candle frame - slow_wave (0-63) and wind gusts are shared by all rings
+static void lighting_candle_frame(uint8_t random_seed, uint8_t slow_wave, bool wind_gust)
+{
     for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
     {
-        g_lighting_state.led_states[i] = 0;
+        candle_ring_t ring;
+        memcpy_P(&ring, &candle_rings[i], sizeof(ring));
+
+        uint8_t flicker = ((uint8_t)(random_seed + ring.seed_offset) * ring.flicker_mul) & ring.flicker_mask;
+
+        g_lighting_state.candle_wave_phase[i] += ring.wave_step;
+        uint8_t wave = (g_lighting_state.candle_wave_phase[i] >> 8) & ring.wave_mask;
+        if (wave > (ring.wave_mask >> 1))
+            wave = ring.wave_mask - wave; // Triangle wave
+
+        int16_t brightness = ring.base;
+        brightness += candle_scale(flicker - (ring.flicker_mask >> 1), ring.k_flicker);
+        brightness += candle_scale(wave - (ring.wave_mask >> 2), ring.k_wave);
+        brightness += candle_scale(slow_wave - 31, ring.k_slow);
+
+        if (wind_gust)
+            brightness -= ring.gust;
+
+        // Clamp: LED_BRIGHTNESS_MIN to the ring's ceiling (the breath boost is added by lighting_compose())
+        uint8_t ceiling = pgm_read_byte(&layer_rings[ring.led].ceiling);
+        if (brightness < LED_BRIGHTNESS_MIN)
+            brightness = LED_BRIGHTNESS_MIN;
+        if (brightness > ceiling)
+            brightness = ceiling;
+
+        // New keyframe: lighting_interpolate() slews toward it over the next frame
+        int16_t delta = (int16_t)brightness - (int16_t)(g_lighting_state.candle_level_q8[i] >> 8);
+        int32_t step = ((int32_t)delta * CANDLE_SLEW_RECIP) >> 8;
+        if (step > (int16_t)ring.slew_max)
+            step = ring.slew_max;
+        if (step < -(int16_t)ring.slew_max)
+            step = -(int16_t)ring.slew_max;
+        if (step == 0 && delta != 0)
+            step = (delta > 0) ? 1 : -1; // Always make progress on small changes
+
+        g_lighting_state.candle_target[i] = (uint8_t)brightness;
+        g_lighting_state.candle_step_q8[i] = (int16_t)step;
     }
+}
+#endif
+
+// Effect output for one ring - shown with the next lighting_compose() commit
+static void lighting_set_base(uint8_t ring, uint8_t level)
+{
+    if (g_lighting_state.base_layer[ring] != level)
+    {
+        g_lighting_state.base_layer[ring] = level;
+        g_lighting_state.layers_dirty = true;
+    }
+}
 
-#ifdef FEATURE_CANDLE_EFFECT
-    lighting_set_effect(LIGHTING_EFFECT_CANDLE);
-#elif FEATURE_BREATHING_EFFECT
-    lighting_set_effect(LIGHTING_EFFECT_BREATHING);
-#elif FEATURE_CANDLE_EFFECT_KRANZ
-    lighting_set_effect(LIGHTING_EFFECT_CANDLE_KRANZ);
+// One saturating pass over the layers, published as a single frame: base + breath boost (the boost
+// stops at the ring's ceiling, brighter effect levels are kept) + audio-reactive overlay
+static void lighting_compose(void)
+{
+#if FEATURE_AUDIO_OUTPUT
+    bool muted = audio_is_song_playing(); // Songs show the overlay alone
+#else
+    bool muted = false;
 #endif
+    if (muted != g_lighting_state.layers_muted)
+    {
+        g_lighting_state.layers_muted = muted;
+        g_lighting_state.layers_dirty = true;
+    }
+    if (!g_lighting_state.layers_dirty)
+    {
+        return;
+    }
+    g_lighting_state.layers_dirty = false;
 
+    uint8_t frame[LED_COUNT_MAX];
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        uint16_t level = 0;
+        if (!muted)
+        {
+            uint8_t base = g_lighting_state.base_layer[i];
+            uint8_t ceiling = pgm_read_byte(&layer_rings[i].ceiling);
+            level = base + (((uint16_t)g_lighting_state.breath_boost * pgm_read_word(&layer_rings[i].boost_gain)) >> LAYER_Q);
+            if (level > ceiling)
+                level = (base > ceiling) ? base : ceiling;
+        }
+#if FEATURE_AUDIO_OUTPUT
+        level += g_lighting_state.envelope_level_q8[i] >> 8;
+#endif
+        frame[i] = (level > LIGHTING_MAX_BRIGHTNESS) ? LIGHTING_MAX_BRIGHTNESS : (uint8_t)level;
+    }
+    hardware_led_commit(frame);
+}
 
+// ============================================================================
+// LIGHTING EFFECTS
+// ============================================================================
 
-    return true;
+#if FEATURE_CANDLE_EFFECT
+static void lighting_candle_init(void)
+{
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        g_lighting_state.candle_wave_phase[i] = (uint16_t)pgm_read_byte(&candle_wave_offsets[i]) << 8;
+    }
+}
+
+// Realistic candle flame physics - one flicker keyframe per frame (LIGHTING_FRAME_MS = CANDLE_FLICKER_SPEED)
+static void lighting_candle_update(void)
+{
+    // Random seed for this frame (xorshift16 - the former 8-bit LCG repeated every 256 frames)
+    uint8_t random_seed = (uint8_t)lighting_random();
+
+    // Common flicker components (shared air currents, etc.) - one step per 8 frames, ~2.5 min per cycle at 150ms
+    uint8_t global_slow_wave = (g_lighting_state.effect_counter / 8) & 0x7F; // 0-127
+    if (global_slow_wave > 63)
+        global_slow_wave = 127 - global_slow_wave; // Triangle wave
+
+    // Global wind effect (affects all rings) - increased frequency
+    bool wind_gust = ((random_seed & 0x1F) == 0x1F); // ~3% chance (was ~1.5%)
+
+    lighting_candle_frame(random_seed, global_slow_wave, wind_gust);
 }
+#endif
 
-// Helper function for non-blocking delay with PWM updates
-static void startup_delay_ms(uint16_t ms)
+#if FEATURE_BREATHING_EFFECT
+static void lighting_breathing_init(void)
 {
-    uint32_t start = hardware_get_millis();
-    while ((hardware_get_millis() - start) < ms)
+    g_lighting_state.breathing_level = 0;
+    g_lighting_state.breathing_rising = true;
+}
+
+// Simple brightness stepping: 50-255 range = 205 levels, ~2s per direction
+static void lighting_breathing_update(void)
+{
+    const uint8_t step = (10 * LIGHTING_BREATHING_FRAME_MS) / 100; // 10 levels per 100ms
+
+    if (g_lighting_state.breathing_rising)
     {
-        hardware_update();  // Keep PWM running during delay
-        _delay_us(10);      // Small delay to prevent excessive CPU usage
+        // Breathing in
+        if (g_lighting_state.breathing_level >= 205 - step) // Reached max (50+205=255)
+        {
+            g_lighting_state.breathing_level = 205;
+            g_lighting_state.breathing_rising = false; // Start breathing out
+        }
+        else
+        {
+            g_lighting_state.breathing_level += step;
+        }
+    }
+    else
+    {
+        // Breathing out
+        if (g_lighting_state.breathing_level >= step)
+        {
+            g_lighting_state.breathing_level -= step;
+        }
+        else
+        {
+            g_lighting_state.breathing_level = 0;
+            g_lighting_state.breathing_rising = true; // Start breathing in
+        }
+    }
+
+    uint8_t current_brightness = 50 + g_lighting_state.breathing_level;
+
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        lighting_set_base(i, current_brightness);
     }
 }
+#endif
+
+#if FEATURE_ADC_TEST_EFFECT
+// ADC sensor test mode - rings light up bottom to top with the microphone level
+static void lighting_adc_test_update(void)
+{
+    // Read filtered ADC value from microphone sensor for stability
+    uint16_t adc_value = hardware_microphone_read(); // 0-1023 (10-bit ADC)
+
+    // Rings above the signal stay off
+    uint8_t levels[LED_COUNT_MAX] = {0};
+
+    // Progressive ADC-to-LED mapping for 1.1V reference
+    // 600mV = ~560 ADC counts (600/1100*1023)
+    // Base ring shows any signal above noise floor
+    if (adc_value > 50) // Noise floor threshold (~50mV)
+    {
+        // Scale ADC (50-560) to brightness (5-255) for base ring
+        uint16_t scaled = (adc_value > 560) ? 560 : adc_value;
+        uint8_t base_brightness = 5 + ((scaled - 50) * 250) / 510;
+        levels[LED_5ER_RING] = base_brightness;
+    }
+
+    // Progressive rings for higher signals
+    if (adc_value > 150) // ~160mV
+    {
+        uint16_t scaled = (adc_value > 560) ? 560 : adc_value;
+        uint8_t mid_brightness = 5 + ((scaled - 150) * 250) / 410;
+        levels[LED_4ER_RING] = mid_brightness;
+    }
+    if (adc_value > 250) // ~270mV
+    {
+        uint16_t scaled = (adc_value > 560) ? 560 : adc_value;
+        uint8_t upper_brightness = 5 + ((scaled - 250) * 250) / 310;
+        levels[LED_3ER_RING] = upper_brightness;
+    }
+    if (adc_value > 400) // ~430mV - getting close to 600mV max
+    {
+        uint16_t scaled = (adc_value > 560) ? 560 : adc_value;
+        uint8_t tip_brightness = 5 + ((scaled - 400) * 250) / 160;
+        levels[LED_1ER_RING] = tip_brightness;
+    }
+
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        lighting_set_base(i, levels[i]);
+    }
+}
+#endif
+
+// ============================================================================
+// EFFECT REGISTRY
+// ============================================================================
+
+// Effects enabled in config.yaml, in cycle order - the others are not linked
+typedef void (*lighting_effect_fn_t)(void);
+
+typedef struct
+{
+    uint8_t effect;              // lighting_effect_t
+    lighting_effect_fn_t init;   // Called by lighting_set_effect(), NULL if the effect keeps no state
+    lighting_effect_fn_t update; // One frame from lighting_update()
+    uint16_t period_ms;          // lighting_update() task period while the effect runs
+} lighting_effect_entry_t;
+
+#define LIGHTING_EFFECT_SLOT_NONE 0xFF
+
+static const lighting_effect_entry_t lighting_effects[LIGHTING_EFFECTS_ENABLED] PROGMEM = {
+#if FEATURE_CANDLE_EFFECT
+    {LIGHTING_EFFECT_CANDLE, lighting_candle_init, lighting_candle_update, LIGHTING_FRAME_MS},
+#endif
+#if FEATURE_BREATHING_EFFECT
+    {LIGHTING_EFFECT_BREATHING, lighting_breathing_init, lighting_breathing_update, LIGHTING_BREATHING_FRAME_MS},
+#endif
+#if FEATURE_ADC_TEST_EFFECT
+    {LIGHTING_EFFECT_ADC_TEST, NULL, lighting_adc_test_update, LIGHTING_ADC_TEST_FRAME_MS},
+#endif
+};
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+bool lighting_init(void)
+{
+    // Initialize lighting state to default values
+    g_lighting_state.current_effect = LIGHTING_EFFECT_NONE;
+    g_lighting_state.effect_slot = LIGHTING_EFFECT_SLOT_NONE;
+    g_lighting_state.effect_counter = 0;
+    g_lighting_state.breath_boost = 0;  // Initialize microphone boost
+    g_lighting_state.random_state = 42; // Any non-zero seed
+
+    // Initialize all layers to off
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        g_lighting_state.base_layer[i] = 0;
+    }
+    g_lighting_state.layers_dirty = true;
+
+    lighting_set_effect(LIGHTING_EFFECT_DEFAULT); // First effect listed in config.yaml
+
+    return true;
+}
 
 void lighting_startup_animation(void)
 {
 #if ENABLE_STARTUP_ANIMATION
-    // Bottom to top LED build-up sequence with final flash
-    // Total duration: ~1000ms
-    
-    uint8_t buildup_brightness = STARTUP_BUILDUP_BRIGHTNESS;  // 1/3 brightness
-    
-    // Turn off all LEDs first
-    hardware_led_all_off();
-    startup_delay_ms(50);
-    
-    // Step 1: Bottom ring (LED_5ER) - 150ms
-    hardware_led_set(LED_5ER_RING, buildup_brightness);
-    startup_delay_ms(STARTUP_STEP_DELAY_MS);
-    
-    // Step 2: Middle ring (LED_4ER) - 300ms total
-    hardware_led_set(LED_4ER_RING, buildup_brightness);
-    startup_delay_ms(STARTUP_STEP_DELAY_MS);
-    
-    // Step 3: Upper ring (LED_3ER) - 450ms total
-    hardware_led_set(LED_3ER_RING, buildup_brightness);
-    startup_delay_ms(STARTUP_STEP_DELAY_MS);
-    
-    // Step 4: Top LED (LED_1ER) - 600ms total
-    hardware_led_set(LED_1ER_RING, buildup_brightness);
-    startup_delay_ms(STARTUP_STEP_DELAY_MS);
-    
-    // Step 5: Turn off all LEDs for dramatic pause
+    // The sequence runs from the scheduler, so microphone sampling and breath detection are live from boot on
     hardware_led_all_off();
-    startup_delay_ms(STARTUP_DARK_PAUSE_MS);
-    
-    // Animation complete - LEDs will be controlled by normal effects
-    // Total time: ~1300ms
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        g_lighting_state.base_layer[i] = 0; // Dark lead-in, the first step is committed by lighting_compose()
+    }
+    g_lighting_state.startup_next_effect = g_lighting_state.current_effect;
+    g_lighting_state.current_effect = LIGHTING_EFFECT_STARTUP;
+    g_lighting_state.effect_slot = LIGHTING_EFFECT_SLOT_NONE; // lighting_update() idles meanwhile
+    g_lighting_state.startup_step = 0;
+    g_lighting_state.startup_time = hardware_get_ticks();
 #endif
 }
 
+#if ENABLE_STARTUP_ANIMATION
+// Apply every step that is due - a song in between just lets the sequence catch up afterwards
+static void lighting_startup_update(void)
+{
+    uint16_t elapsed = hardware_get_ticks() - g_lighting_state.startup_time;
+    const startup_step_t *step = &startup_steps[g_lighting_state.startup_step];
+    while (elapsed >= pgm_read_word(&step->at_ms))
+    {
+        uint8_t ring_mask = pgm_read_byte(&step->ring_mask);
+        if (ring_mask == STARTUP_END)
+        {
+            lighting_set_effect(g_lighting_state.startup_next_effect); // Back to the effect set before (candle)
+            return;
+        }
+
+        for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+        {
+            lighting_set_base(i, (ring_mask & (1 << i)) ? STARTUP_BUILDUP_BRIGHTNESS : 0);
+        }
+        g_lighting_state.startup_step++;
+        step++;
+    }
+}
+#endif
+
 void lighting_update(void)
 {
 #if FEATURE_AUDIO_OUTPUT
@@ -130,327 +521,232 @@ void lighting_update(void)
     }
 #endif
 
-    uint32_t current_time = hardware_get_millis();
-
-    g_lighting_state.last_update_time = current_time;
-
-    // Handle current effect
-    if (g_lighting_state.current_effect == LIGHTING_EFFECT_NONE)
+    // Called once per period_ms of the current effect by the scheduler
+    uint8_t slot = g_lighting_state.effect_slot;
+    if (slot == LIGHTING_EFFECT_SLOT_NONE)
     {
         return;
     }
 
-    g_lighting_state.effect_counter++;
+    const lighting_effect_entry_t *entry = &lighting_effects[slot];
+    g_lighting_state.effect_counter++; // Frames - the slow candle wave steps every 8, whatever the frame period
 
-    switch (g_lighting_state.current_effect)
-    {
+    lighting_effect_fn_t update = (lighting_effect_fn_t)pgm_read_ptr(&entry->update);
+    update();
+}
 
-    case LIGHTING_EFFECT_BREATHING:
+#if FEATURE_AUDIO_OUTPUT
+// One envelope step per PWM frame: attacking rings approach their peak, the others decay exponentially
+static void lighting_audio_envelope_step(void)
+{
+    uint16_t now = hardware_get_ticks();
+    if ((uint16_t)(now - g_lighting_state.envelope_time) < AUDIO_ENVELOPE_STEP_MS)
     {
-        // ISR-based breathing timing for rock-solid stability
-        static uint8_t brightness_counter = 0;
-        static uint8_t brightness_direction = 1; // 1 = up, 0 = down
-        static uint32_t last_update_time = 0;
+        return;
+    }
+    g_lighting_state.envelope_time = now;
 
-        // Update every 100ms using stable ISR timing
-        if (current_time - last_update_time >= 100)
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        uint16_t level = g_lighting_state.envelope_level_q8[i];
+        if (g_lighting_state.envelope_attack_mask & (1 << i))
         {
-            last_update_time = current_time;
-
-            // Simple brightness stepping: 50-255 range = 205 levels
-            // 20 steps per direction, so step size = 205/20 ≈ 10
-            if (brightness_direction == 1)
-            {
-                // Breathing in
-                brightness_counter += 10;
-                if (brightness_counter >= 205) // Reached max (50+205=255)
-                {
-                    brightness_counter = 205;
-                    brightness_direction = 0; // Start breathing out
-                }
-            }
-            else
-            {
-                // Breathing out
-                if (brightness_counter >= 10)
-                {
-                    brightness_counter -= 10;
-                }
-                else
-                {
-                    brightness_counter = 0;
-                    brightness_direction = 1; // Start breathing in
-                }
-            }
+            uint16_t peak_q8 = (uint16_t)g_lighting_state.envelope_peak[i] << 8;
+            level = (peak_q8 > level) ? level + ((peak_q8 - level) >> AUDIO_ENVELOPE_ATTACK_SHIFT) : peak_q8;
+            if (peak_q8 - level < 256)
+                level = peak_q8; // Hold at the peak until the note ends
         }
-
-        uint8_t current_brightness = 50 + brightness_counter;
-
-        for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+        else if (level > 0)
         {
-            hardware_led_set((led_id_t)i, current_brightness);
+            level -= level >> AUDIO_ENVELOPE_DECAY_SHIFT;
+            if (level < 256)
+                level = 0; // Below one brightness step - off
         }
+        else
+        {
+            continue; // Dark ring, nothing to update
+        }
+
+        if ((level >> 8) != (g_lighting_state.envelope_level_q8[i] >> 8))
+            g_lighting_state.layers_dirty = true;
+        g_lighting_state.envelope_level_q8[i] = level;
     }
-    break;
+}
+#endif
 
-    case LIGHTING_EFFECT_CANDLE:
+// Millisecond layer updates: song envelopes, startup steps or the candle slew
+static void lighting_step_layers(void)
+{
+#if FEATURE_AUDIO_OUTPUT
+    // Audio-reactive lighting owns the LEDs during songs
+    if (audio_is_song_playing())
     {
-        // Realistic candle flame physics - different behavior per ring level (ATtiny85+)
-        static uint8_t random_seed = 42;      // Simple random number seed
-        static uint32_t last_update_time = 0; // Timing control like ATtiny13
+        lighting_audio_envelope_step();
+        return;
+    }
+#endif
 
-        // Update candle flicker at configurable interval
-        if (current_time - last_update_time >= CANDLE_FLICKER_SPEED)
-        {
-            last_update_time = current_time;
-
-            // Update random seed for this frame
-            random_seed = (random_seed * 13 + 37) & 0xFF;
-
-            // Common flicker components (shared air currents, etc.)
-            uint8_t global_slow_wave = (g_lighting_state.effect_counter / 8) & 0x7F; // 0-127
-            if (global_slow_wave > 63)
-                global_slow_wave = 127 - global_slow_wave; // Triangle wave
-
-            // Global wind effect (affects all rings) - increased frequency
-            bool wind_gust = ((random_seed & 0x1F) == 0x1F); // ~3% chance (was ~1.5%)
-
-            // === LED_1ER_RING (TIP) - Maximum flicker, most dramatic ===
-            {
-                uint8_t tip_seed = random_seed + 7;
-                uint8_t fast_flicker = (tip_seed * 5) & 0x3F;                           // 0-63 range (most active)
-                uint8_t medium_wave = (g_lighting_state.effect_counter / 1 + 3) & 0x1F; // Fast medium
-                if (medium_wave > 15)
-                    medium_wave = 31 - medium_wave;
-
-                int16_t tip_brightness = (LED_BRIGHTNESS_DEFAULT * CANDLE_TIP_BRIGHTNESS_PCT) / 100; // Configurable base brightness
-                tip_brightness += ((fast_flicker - 31) * CANDLE_FLICKER_INTENSITY) / 100;                // Scaled dramatic variation
-                tip_brightness += ((medium_wave - 7) * 3 * CANDLE_FLICKER_INTENSITY) / 100;              // Scaled medium variation
-                tip_brightness += ((global_slow_wave - 31) * CANDLE_FLICKER_INTENSITY) / 200;            // Scaled slow variation
-
-                if (wind_gust)
-                    tip_brightness -= (30 * CANDLE_FLICKER_INTENSITY) / 100; // Scaled wind effect
-
-                // Apply microphone intensity boost - increased for better visibility (0-100 maps to 0-80 extra brightness)
-                tip_brightness += (g_lighting_state.candle_intensity_boost * 4 / 5);
-
-                // Clamp tip range: LED_BRIGHTNESS_MIN to configurable max (extended for microphone boost)
-                if (tip_brightness < LED_BRIGHTNESS_MIN)
-                    tip_brightness = LED_BRIGHTNESS_MIN;
-                if (tip_brightness > 180)
-                    tip_brightness = 180;
-
-                hardware_led_set(LED_1ER_RING, (uint8_t)tip_brightness);
-            }
-
-            // === LED_3ER_RING (UPPER) - High flicker, second most active ===
-            {
-                uint8_t upper_seed = random_seed + 13;
-                uint8_t fast_flicker = (upper_seed * 3) & 0x1F; // 0-31 range (high activity)
-                uint8_t medium_wave = (g_lighting_state.effect_counter / 2 + 7) & 0x1F;
-                if (medium_wave > 15)
-                    medium_wave = 31 - medium_wave;
-
-                int16_t upper_brightness = (LED_BRIGHTNESS_DEFAULT * CANDLE_UPPER_BRIGHTNESS_PCT) / 100; // Configurable base brightness
-                upper_brightness += ((fast_flicker - 15) * CANDLE_FLICKER_INTENSITY) / 100;                  // Scaled variation
-                upper_brightness += ((medium_wave - 7) * 2 * CANDLE_FLICKER_INTENSITY) / 100;                // Scaled medium variation
-                upper_brightness += ((global_slow_wave - 31) * CANDLE_FLICKER_INTENSITY) / 300;              // Scaled slow variation
-
-                if (wind_gust)
-                    upper_brightness -= (25 * CANDLE_FLICKER_INTENSITY) / 100; // Scaled wind effect
-
-                // Apply microphone intensity boost - increased (0-100 maps to 0-70 extra brightness)
-                upper_brightness += (g_lighting_state.candle_intensity_boost * 7 / 10);
-
-                // Clamp upper range: LED_BRIGHTNESS_MIN to configurable max (extended for microphone boost)
-                if (upper_brightness < LED_BRIGHTNESS_MIN)
-                    upper_brightness = LED_BRIGHTNESS_MIN;
-                if (upper_brightness > 140)
-                    upper_brightness = 140;
-
-                hardware_led_set(LED_3ER_RING, (uint8_t)upper_brightness);
-            }
-
-            // === LED_4ER_RING (MIDDLE) - Medium flicker, more stable ===
-            {
-                uint8_t middle_seed = random_seed + 19;
-                uint8_t fast_flicker = (middle_seed * 2) & 0x0F; // 0-15 range (moderate activity)
-                uint8_t medium_wave = (g_lighting_state.effect_counter / 3 + 11) & 0x0F;
-                if (medium_wave > 7)
-                    medium_wave = 15 - medium_wave;
-
-                int16_t middle_brightness = (LED_BRIGHTNESS_DEFAULT * CANDLE_MIDDLE_BRIGHTNESS_PCT) / 100; // Configurable base brightness
-                middle_brightness += ((fast_flicker - 7) * CANDLE_FLICKER_INTENSITY) / 100;                    // Scaled variation
-                middle_brightness += ((medium_wave - 3) * 2 * CANDLE_FLICKER_INTENSITY) / 100;                 // Scaled medium variation
-                middle_brightness += ((global_slow_wave - 31) * CANDLE_FLICKER_INTENSITY) / 400;               // Scaled slow variation
-
-                if (wind_gust)
-                    middle_brightness -= (20 * CANDLE_FLICKER_INTENSITY) / 100; // Scaled wind effect
-
-                // Apply microphone intensity boost - increased (0-100 maps to 0-60 extra brightness)
-                middle_brightness += (g_lighting_state.candle_intensity_boost * 3 / 5);
-
-                // Clamp middle range: LED_BRIGHTNESS_MIN to configurable max (extended for microphone boost)
-                if (middle_brightness < LED_BRIGHTNESS_MIN)
-                    middle_brightness = LED_BRIGHTNESS_MIN;
-                if (middle_brightness > 100)
-                    middle_brightness = 100;
-
-                hardware_led_set(LED_4ER_RING, (uint8_t)middle_brightness);
-            }
-
-            // === LED_5ER_RING (BASE) - Gentle glow, most stable ===
-            {
-                uint8_t base_seed = random_seed + 23;
-                uint8_t gentle_flicker = (base_seed) & 0x07; // 0-7 range (minimal activity)
-                uint8_t slow_variation = (g_lighting_state.effect_counter / 6) & 0x07;
-                if (slow_variation > 3)
-                    slow_variation = 7 - slow_variation;
-
-                int16_t base_brightness = (LED_BRIGHTNESS_DEFAULT * CANDLE_BASE_BRIGHTNESS_PCT) / 100; // Configurable base brightness
-                base_brightness += ((gentle_flicker - 3) * 2 * CANDLE_FLICKER_INTENSITY) / 100;            // Scaled gentle variation
-                base_brightness += ((slow_variation - 1) * 2 * CANDLE_FLICKER_INTENSITY) / 100;            // Scaled very slow variation
-                base_brightness += ((global_slow_wave - 31) * CANDLE_FLICKER_INTENSITY) / 600;             // Scaled minimal slow variation
-
-                if (wind_gust)
-                    base_brightness -= (12 * CANDLE_FLICKER_INTENSITY) / 100; // Scaled wind effect
-
-                // Apply microphone intensity boost - increased (0-100 maps to 0-40 extra brightness)
-                base_brightness += (g_lighting_state.candle_intensity_boost * 2 / 5);
-
-                // Clamp base range: LED_BRIGHTNESS_MIN to configurable max (extended for microphone boost)
-                if (base_brightness < LED_BRIGHTNESS_MIN)
-                    base_brightness = LED_BRIGHTNESS_MIN;
-                if (base_brightness > 70)
-                    base_brightness = 70;
-
-                hardware_led_set(LED_5ER_RING, (uint8_t)base_brightness);
-            }
-        }
+#if ENABLE_STARTUP_ANIMATION
+    // Millisecond steps - the effect frame (CANDLE_FLICKER_SPEED) is too coarse for the 50/80ms phases
+    if (g_lighting_state.current_effect == LIGHTING_EFFECT_STARTUP)
+    {
+        lighting_startup_update();
+        return;
     }
-    break;
+#endif
 
-    case LIGHTING_EFFECT_ADC_TEST:
+#if FEATURE_CANDLE_EFFECT
+    if (g_lighting_state.current_effect != LIGHTING_EFFECT_CANDLE)
     {
-        // Read filtered ADC value from microphone sensor for stability
-        uint16_t adc_value = hardware_microphone_read(); // 0-1023 (10-bit ADC)
+        return;
+    }
 
-        // Turn off all LEDs first
-        hardware_led_set(LED_1ER_RING, 0);
-        hardware_led_set(LED_3ER_RING, 0);
-        hardware_led_set(LED_4ER_RING, 0);
-        hardware_led_set(LED_5ER_RING, 0);
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        uint16_t target_q8 = (uint16_t)g_lighting_state.candle_target[i] << 8;
+        uint16_t level = g_lighting_state.candle_level_q8[i];
+        int16_t step = g_lighting_state.candle_step_q8[i];
 
-        // Progressive ADC-to-LED mapping for 1.1V reference
-        // 600mV = ~560 ADC counts (600/1100*1023)
-        // Base ring shows any signal above noise floor
-        if (adc_value > 50) // Noise floor threshold (~50mV)
+        // Linear slew, stopping on the keyframe target
+        if (step > 0)
         {
-            // Scale ADC (50-560) to brightness (5-255) for base ring
-            uint16_t scaled = (adc_value > 560) ? 560 : adc_value;
-            uint8_t base_brightness = 5 + ((scaled - 50) * 250) / 510;
-            hardware_led_set(LED_5ER_RING, base_brightness);
+            level = (target_q8 - level > (uint16_t)step) ? level + step : target_q8;
         }
-
-        // Progressive rings for higher signals
-        if (adc_value > 150) // ~160mV
+        else if (step < 0)
         {
-            uint16_t scaled = (adc_value > 560) ? 560 : adc_value;
-            uint8_t mid_brightness = 5 + ((scaled - 150) * 250) / 410;
-            hardware_led_set(LED_4ER_RING, mid_brightness);
+            level = (level - target_q8 > (uint16_t)-step) ? level + step : target_q8;
         }
-        if (adc_value > 250) // ~270mV
+        g_lighting_state.candle_level_q8[i] = level;
+
+        lighting_set_base(pgm_read_byte(&candle_rings[i].led), (uint8_t)(level >> 8));
+    }
+#endif
+}
+
+void lighting_interpolate(void)
+{
+    lighting_step_layers();
+    lighting_compose(); // One commit for all rings, only when a layer changed
+}
+
+void lighting_set_effect(lighting_effect_t effect)
+{
+    g_lighting_state.current_effect = effect;
+    g_lighting_state.effect_counter = 0;
+    g_lighting_state.effect_slot = LIGHTING_EFFECT_SLOT_NONE; // Not linked in - lighting_update() idles
+
+    for (uint8_t slot = 0; slot < LIGHTING_EFFECTS_ENABLED; slot++)
+    {
+        const lighting_effect_entry_t *entry = &lighting_effects[slot];
+        if (pgm_read_byte(&entry->effect) != effect)
         {
-            uint16_t scaled = (adc_value > 560) ? 560 : adc_value;
-            uint8_t upper_brightness = 5 + ((scaled - 250) * 250) / 310;
-            hardware_led_set(LED_3ER_RING, upper_brightness);
+            continue;
         }
-        if (adc_value > 400) // ~430mV - getting close to 600mV max
+
+        g_lighting_state.effect_slot = slot;
+        lighting_effect_fn_t init = (lighting_effect_fn_t)pgm_read_ptr(&entry->init);
+        if (init)
         {
-            uint16_t scaled = (adc_value > 560) ? 560 : adc_value;
-            uint8_t tip_brightness = 5 + ((scaled - 400) * 250) / 160;
-            hardware_led_set(LED_1ER_RING, tip_brightness);
+            init();
         }
-    }
-    break;
-
-    default:
-        break;
+        scheduler_set_period(lighting_update, pgm_read_word(&entry->period_ms));
+        return;
     }
 }
 
-void lighting_set_effect(lighting_effect_t effect)
+void lighting_next_effect(void)
 {
+    uint8_t slot = g_lighting_state.effect_slot;
+    if (slot == LIGHTING_EFFECT_SLOT_NONE)
+    {
+        return; // Startup sequence - it resumes the effect it interrupted
+    }
 
-    g_lighting_state.current_effect = effect;
-    g_lighting_state.effect_counter = 0;
+    if (++slot >= LIGHTING_EFFECTS_ENABLED)
+    {
+        slot = 0;
+    }
+    lighting_set_effect((lighting_effect_t)pgm_read_byte(&lighting_effects[slot].effect));
 }
 
-void lighting_set_candle_intensity_boost(uint8_t boost)
+void lighting_set_breath_boost(uint8_t boost)
 {
     // Limit boost to 0-100 range
     if (boost > 100)
     {
         boost = 100;
     }
-    g_lighting_state.candle_intensity_boost = boost;
+    if (boost != g_lighting_state.breath_boost)
+    {
+        g_lighting_state.breath_boost = boost;
+        g_lighting_state.layers_dirty = true;
+    }
 }
 
 // ============================================================================
 // AUDIO-REACTIVE LIGHTING FUNCTIONS
 // ============================================================================
 
-void lighting_audio_reactive_note(uint16_t frequency)
+void lighting_audio_reactive_note(uint16_t frequency, uint16_t duration_ms)
 {
-    // Skip silent notes (frequency = 0)
+    // The previous note's ring (if any) decays from here on (also covers silent notes, frequency = 0)
+    lighting_audio_reactive_release();
+
     if (frequency == 0)
     {
-        lighting_audio_reactive_off();
         return;
     }
 
-    // Configure LED_3ER for audio mode (inlined - temporary override of mic setup)
-    DDRB |= (1 << PIN_LED_3ER);   // PB3 as output for LED control during songs
-    PORTB &= ~(1 << PIN_LED_3ER); // Ensure LED_3ER starts off
-
-    // Turn off all audio-reactive LEDs first
-    lighting_audio_reactive_off();
-
-    // DEBUG: Uncomment the next 2 lines to light all LEDs for any note (test mode)
-    // PORTB |= (1 << PIN_LED_1ER) | (1 << PIN_LED_3ER) | (1 << PIN_LED_4ER) | (1 << PIN_LED_5ER);
-    // return;
-
-    // Direct pin manipulation - simple and stable (4-LED setup)
+    // Rings are driven through the PWM engine so it keeps running during songs
     // Higher frequencies → lower ring numbers (top to bottom)
+    led_id_t ring;
 
     // LED_1ER (Tip): Highest notes C5 and above
     if (frequency >= AUDIO_NOTE_LED_1ER_MIN)
     {
-        PORTB |= (1 << PIN_LED_1ER); // Turn on LED_1ER directly
+        ring = LED_1ER_RING;
     }
     // LED_3ER (Upper): High-mid notes A4 to B4
     else if (frequency >= AUDIO_NOTE_LED_3ER_MIN && frequency <= AUDIO_NOTE_LED_3ER_MAX)
     {
-        PORTB |= (1 << PIN_LED_3ER); // Turn on LED_3ER directly - OK during songs
+        ring = LED_3ER_RING; // Peak below 255 still leaves mic sampling windows on PB3
     }
     // LED_4ER (Middle): Mid notes F4 to G4
     else if (frequency >= AUDIO_NOTE_LED_4ER_MIN && frequency <= AUDIO_NOTE_LED_4ER_MAX)
     {
-        PORTB |= (1 << PIN_LED_4ER); // Turn on LED_4ER directly
+        ring = LED_4ER_RING;
     }
     // LED_5ER (Base): Low notes E4 and below
     else if (frequency <= AUDIO_NOTE_LED_5ER_MAX)
     {
-        PORTB |= (1 << PIN_LED_5ER); // Turn on LED_5ER directly
+        ring = LED_5ER_RING;
+    }
+    else
+    {
+        return;
     }
-    // LED_3ER: Not used - shared with microphone
+
+    // Velocity from the note length: short notes flash dimmer than held ones
+    uint16_t velocity = duration_ms >> AUDIO_REACTIVE_VELOCITY_SHIFT;
+    if (velocity > 255)
+        velocity = 255;
+    g_lighting_state.envelope_peak[ring] = AUDIO_REACTIVE_MIN_BRIGHTNESS +
+        (uint8_t)(((uint16_t)(AUDIO_REACTIVE_BRIGHTNESS - AUDIO_REACTIVE_MIN_BRIGHTNESS) * (uint8_t)velocity) >> 8);
+    g_lighting_state.envelope_attack_mask = (uint8_t)(1 << ring);
+}
+
+void lighting_audio_reactive_release(void)
+{
+    g_lighting_state.envelope_attack_mask = 0;
 }
 
 void lighting_audio_reactive_off(void)
 {
-    // Turn off audio-reactive LEDs directly - simple and fast (4-LED setup)
-    PORTB &= ~(1 << PIN_LED_1ER); // Turn off LED_1ER
-    PORTB &= ~(1 << PIN_LED_3ER); // Turn off LED_3ER - OK during songs
-    PORTB &= ~(1 << PIN_LED_4ER); // Turn off LED_4ER
-    PORTB &= ~(1 << PIN_LED_5ER); // Turn off LED_5ER
+    // Clear the overlay - the effect layers are shown again with the next commit
+    g_lighting_state.envelope_attack_mask = 0;
+    for (uint8_t i = 0; i < LED_COUNT_MAX; i++)
+    {
+        g_lighting_state.envelope_level_q8[i] = 0;
+    }
+    g_lighting_state.layers_dirty = true;
 }
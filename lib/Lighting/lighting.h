@@ -26,14 +26,28 @@ extern "C"
 
 #define LIGHTING_MAX_BRIGHTNESS 255
 #define LIGHTING_DEFAULT_SPEED 100
-#define LIGHTING_UPDATE_INTERVAL_MS 50
+
+    // Effect Registry Configuration (effects selected in config.yaml, candle frame = LIGHTING_FRAME_MS)
+#define LIGHTING_BREATHING_FRAME_MS 20      // Breathing step period - 2 levels per frame, ~2s per direction
+#define LIGHTING_ADC_TEST_FRAME_MS 50       // Microphone level refresh of the ADC test effect
+#define LIGHTING_EFFECTS_ENABLED (FEATURE_CANDLE_EFFECT + FEATURE_BREATHING_EFFECT + FEATURE_ADC_TEST_EFFECT)
+#if LIGHTING_EFFECTS_ENABLED == 0
+#error "config.yaml lighting.effects enables no lighting effect"
+#endif
 
     // Startup Animation Configuration
-#define STARTUP_ANIMATION_DURATION_MS 1000  // Total duration of startup sequence
 #define STARTUP_STEP_DELAY_MS 150           // Delay between each LED ring lighting up
-#define STARTUP_FLASH_DURATION_MS 250       // Duration of final brightness flash
-#define STARTUP_DARK_PAUSE_MS 80           // Duration of dark pause after flash
+#define STARTUP_DARK_PAUSE_MS 80            // Duration of dark pause after the build-up
 #define STARTUP_BUILDUP_BRIGHTNESS 85       // 1/3 of max brightness (255/3) for buildup phase
+#define STARTUP_LEAD_IN_MS 50               // All dark before the first ring
+
+    // Audio-Reactive Lighting Configuration
+#define AUDIO_REACTIVE_BRIGHTNESS 240       // Envelope peak of long notes - below 255 keeps a PWM LOW phase for mic sampling on PB3
+#define AUDIO_REACTIVE_MIN_BRIGHTNESS 96    // Envelope peak of the shortest notes
+#define AUDIO_REACTIVE_VELOCITY_SHIFT 1     // Velocity = note ms >> shift, 0-255 (full peak from ~510ms)
+#define AUDIO_ENVELOPE_STEP_MS 10           // One envelope step per software PWM frame (10.24ms)
+#define AUDIO_ENVELOPE_ATTACK_SHIFT 1       // Attack closes 1/2 of the way to the peak per step (~30ms to 90%)
+#define AUDIO_ENVELOPE_DECAY_SHIFT 3        // Release loses 1/8 per step (~50ms half-life)
 
     // ============================================================================
     // LIGHTING EFFECTS
@@ -84,16 +98,19 @@ extern "C"
 
     // System initialization and control
     bool lighting_init(void);
-    void lighting_update(void);
-    void lighting_startup_animation(void);  // Blocking startup animation
+    void lighting_update(void);      // One effect frame (keyframe for the candle), at the period of the current effect
+    void lighting_interpolate(void); // Step the layers (candle slew, envelopes, startup), commit the composed frame - every LIGHTING_SLEW_MS
+    void lighting_startup_animation(void);  // Start the startup effect - runs from lighting_interpolate, then the current effect resumes
 
     // Effect control
-    void lighting_set_effect(lighting_effect_t effect);
-    void lighting_set_candle_intensity_boost(uint8_t boost); // 0-100 additional intensity
-
-    // Audio-reactive lighting functions (simple on/off control - 4-LED setup)
-    void lighting_audio_reactive_note(uint16_t frequency); // Light LED rings based on note frequency (direct pin control)
-    void lighting_audio_reactive_off(void);                // Turn off all audio-reactive LEDs (direct pin control)
+    void lighting_set_effect(lighting_effect_t effect); // Runs the effect's init, sets the lighting_update() period (idle if not enabled)
+    void lighting_next_effect(void);                    // Cycle to the next enabled effect (long blow)
+    void lighting_set_breath_boost(uint8_t boost);      // 0-100 breath boost layer, added on top of any effect up to each ring's ceiling
+
+    // Audio-reactive lighting functions (attack/release envelope per ring, stepped by lighting_interpolate)
+    void lighting_audio_reactive_note(uint16_t frequency, uint16_t duration_ms); // Attack the ring of a note frequency, peak from the duration
+    void lighting_audio_reactive_release(void);                                  // Note ended - every ring decays
+    void lighting_audio_reactive_off(void);                                      // Turn off all audio-reactive LEDs at once (song end)
 
     // All other lighting effects removed - were never implemented
 
@@ -0,0 +1,82 @@
+/*
+ * profiler.cpp - On-target profiling counters for BlinkyTree (debug builds)
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ *
+ * min/max/total/count per probe from the free-running Timer0 stamp, dumped to EEPROM
+ */
+
+#include "profiler.h"
+#include <string.h>
+
+#if PROF_ENABLED
+
+// ============================================================================
+// PRIVATE VARIABLES
+// ============================================================================
+
+static uint16_t g_prof_start[PROF_COUNT];
+static prof_entry_t g_prof_table[PROF_COUNT];
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void profiler_init(void)
+{
+    memset(g_prof_table, 0, sizeof(g_prof_table));
+    for (uint8_t i = 0; i < PROF_COUNT; i++)
+    {
+        g_prof_table[i].min = UINT16_MAX;
+    }
+}
+
+void profiler_begin(uint8_t id)
+{
+    g_prof_start[id] = hardware_get_cycle_stamp();
+}
+
+void profiler_end(uint8_t id)
+{
+    uint16_t elapsed = hardware_get_cycle_stamp() - g_prof_start[id]; // Wrap-safe below 65536 clocks
+    prof_entry_t *entry = &g_prof_table[id];
+
+    if (entry->count == UINT16_MAX)
+    {
+        return; // Saturated - keeps min/max/average consistent
+    }
+    entry->count++;
+    entry->total += elapsed;
+    if (elapsed < entry->min)
+        entry->min = elapsed;
+    if (elapsed > entry->max)
+        entry->max = elapsed;
+}
+
+void profiler_dump(void)
+{
+    // Header: magic, probe count, CPU cycles per stamp, entry size - then the entries, little-endian
+    hardware_eeprom_write_byte(EEPROM_ADDR_PROFILE, PROF_EEPROM_MAGIC);
+    hardware_eeprom_write_byte(EEPROM_ADDR_PROFILE + 1, PROF_COUNT);
+    hardware_eeprom_write_byte(EEPROM_ADDR_PROFILE + 2, HARDWARE_STAMP_CYCLES);
+    hardware_eeprom_write_byte(EEPROM_ADDR_PROFILE + 3, sizeof(prof_entry_t));
+
+    uint16_t address = EEPROM_ADDR_PROFILE + 4;
+    for (uint8_t i = 0; i < PROF_COUNT; i++)
+    {
+        prof_entry_t entry;
+        cli(); // The PWM ISR probe updates its entry at any time
+        entry = g_prof_table[i];
+        sei();
+
+        const uint8_t *bytes = (const uint8_t *)&entry;
+        for (uint8_t b = 0; b < sizeof(entry); b++)
+        {
+            hardware_eeprom_write_byte(address++, bytes[b]); // Unchanged bytes are skipped
+        }
+    }
+}
+
+#endif // PROF_ENABLED
@@ -0,0 +1,62 @@
+/*
+ * profiler.h - On-target profiling counters for BlinkyTree (debug builds)
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../config/config.h"
+#include "../Hardware/hardware.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // PROBES
+    // ============================================================================
+
+    typedef enum
+    {
+        PROF_TASK_0 = 0,                          // Scheduler tasks, main_tasks[] order (audio_update, ...)
+        PROF_MIC_READ = SCHEDULER_MAX_TASKS,      // hardware_microphone_read()
+        PROF_PWM_ISR,                             // Software PWM step (edge-schedule and HW PWM ISRs, not BAM)
+        PROF_DDS_ISR,                             // Two-voice DDS sample (FEATURE_AUDIO_DDS)
+        PROF_COUNT
+    } prof_id_t;
+
+    // Per-probe statistics in Timer0 clocks (HARDWARE_STAMP_CYCLES CPU cycles each)
+    typedef struct
+    {
+        uint16_t count;
+        uint16_t min;
+        uint16_t max;
+        uint32_t total;
+    } prof_entry_t;
+
+#if PROF_ENABLED
+    // Probe pair around a block - one pass at a time per id (ISR probes get their own id)
+#define PROF_BEGIN(id) profiler_begin(id)
+#define PROF_END(id) profiler_end(id)
+
+    void profiler_init(void);
+    void profiler_begin(uint8_t id);
+    void profiler_end(uint8_t id);
+    void profiler_dump(void); // Write the table to EEPROM at EEPROM_ADDR_PROFILE (scripts/read_profile.py)
+#else
+#define PROF_BEGIN(id)
+#define PROF_END(id)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILER_H_
@@ -0,0 +1,126 @@
+/*
+ * scheduler.cpp - Cooperative periodic-task scheduler for BlinkyTree
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ *
+ * Fixed task table in flash, periods and 16-bit tick deadlines in RAM, IDLE sleep between them
+ */
+
+#include "scheduler.h"
+#include <avr/pgmspace.h>
+#include "../Hardware/hardware.h"
+#include "../Profiler/profiler.h"
+#include "../Telemetry/telemetry.h"
+
+// ============================================================================
+// PRIVATE VARIABLES
+// ============================================================================
+
+static const scheduler_task_t *g_scheduler_tasks; // PROGMEM
+static uint8_t g_scheduler_task_count;
+static uint16_t g_scheduler_period[SCHEDULER_MAX_TASKS];   // Table period, or the one set by scheduler_set_period()
+static uint16_t g_scheduler_next_due[SCHEDULER_MAX_TASKS]; // hardware_get_ticks() deadline per task
+static uint8_t g_scheduler_overruns[SCHEDULER_MAX_TASKS];
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void scheduler_init(const scheduler_task_t *tasks, uint8_t count)
+{
+    g_scheduler_tasks = tasks;
+    g_scheduler_task_count = (count > SCHEDULER_MAX_TASKS) ? SCHEDULER_MAX_TASKS : count;
+
+    for (uint8_t i = 0; i < g_scheduler_task_count; i++)
+    {
+        g_scheduler_period[i] = pgm_read_word(&g_scheduler_tasks[i].period_ms);
+        g_scheduler_overruns[i] = 0;
+    }
+}
+
+void scheduler_set_period(scheduler_task_fn_t run, uint16_t period_ms)
+{
+    for (uint8_t i = 0; i < g_scheduler_task_count; i++)
+    {
+        if ((scheduler_task_fn_t)pgm_read_ptr(&g_scheduler_tasks[i].run) == run)
+        {
+            g_scheduler_period[i] = period_ms; // The next slot is already booked, the new period applies after it
+        }
+    }
+}
+
+void scheduler_run(void)
+{
+    // Every task is due on entry - the module init before it does not count as lateness
+    uint16_t start = hardware_get_ticks();
+    for (uint8_t i = 0; i < g_scheduler_task_count; i++)
+    {
+        g_scheduler_next_due[i] = start;
+    }
+
+    while (1)
+    {
+        SIM_MARK_LOOP_BUSY();
+        TELEM_LOOP_BEGIN();
+        uint16_t now = hardware_get_ticks();
+        uint16_t deadline = now + INT16_MAX;
+
+        for (uint8_t i = 0; i < g_scheduler_task_count; i++)
+        {
+            int16_t late = (int16_t)(now - g_scheduler_next_due[i]);
+            if (late >= 0)
+            {
+                uint16_t period = g_scheduler_period[i];
+
+                // Book the next slot before running - the task may resync the table
+                if ((uint16_t)late >= period)
+                {
+                    // Missed at least one slot: count it and skip ahead instead of bursting
+                    if (g_scheduler_overruns[i] < UINT8_MAX)
+                    {
+                        g_scheduler_overruns[i]++;
+                    }
+                    g_scheduler_next_due[i] = now + period;
+                }
+                else
+                {
+                    g_scheduler_next_due[i] += period; // Drift-free
+                }
+
+                scheduler_task_fn_t run = (scheduler_task_fn_t)pgm_read_ptr(&g_scheduler_tasks[i].run);
+                PROF_BEGIN(PROF_TASK_0 + i);
+                run();
+                PROF_END(PROF_TASK_0 + i);
+            }
+
+            if ((int16_t)(g_scheduler_next_due[i] - deadline) < 0)
+            {
+                deadline = g_scheduler_next_due[i];
+            }
+        }
+
+        // Sleep through the PWM-step wake-ups until the nearest deadline
+        TELEM_LOOP_END();
+        SIM_MARK_LOOP_IDLE();
+        while ((int16_t)(deadline - hardware_get_ticks()) > 0)
+        {
+            hardware_idle();
+        }
+    }
+}
+
+void scheduler_resync(void)
+{
+    uint16_t now = hardware_get_ticks();
+    for (uint8_t i = 0; i < g_scheduler_task_count; i++)
+    {
+        g_scheduler_next_due[i] = now + g_scheduler_period[i];
+    }
+}
+
+uint8_t scheduler_get_overruns(uint8_t task)
+{
+    return (task < g_scheduler_task_count) ? g_scheduler_overruns[task] : 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * scheduler.h - Cooperative periodic-task scheduler for BlinkyTree
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../config/config.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // TASK TABLE
+    // ============================================================================
+
+    typedef void (*scheduler_task_fn_t)(void);
+
+    // One periodic task - the table lives in PROGMEM, periods and deadlines are kept in RAM
+    typedef struct
+    {
+        scheduler_task_fn_t run; // Called once per period from the dispatch loop
+        uint16_t period_ms;      // 1 to 32767 ms (deadlines compare as signed 16-bit ticks), initial period
+    } scheduler_task_t;
+
+    // ============================================================================
+    // SCHEDULER FUNCTIONS
+    // ============================================================================
+
+    // tasks: PROGMEM table of count (<= SCHEDULER_MAX_TASKS) entries - before the module init, so it can set periods
+    void scheduler_init(const scheduler_task_t *tasks, uint8_t count);
+
+    // Change the period of the task(s) running run (e.g. per lighting effect), no-op if not in the table
+    void scheduler_set_period(scheduler_task_fn_t run, uint16_t period_ms);
+
+    // Dispatch due tasks in table order, all due on entry, sleep until the nearest deadline - never returns
+    void scheduler_run(void);
+
+    // Reschedule every task one period from now (after the tick counter jumped, e.g. standby)
+    void scheduler_resync(void);
+
+    // Periods missed by a task (its run came a full period or more late), saturates at 255
+    uint8_t scheduler_get_overruns(uint8_t task);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCHEDULER_H_
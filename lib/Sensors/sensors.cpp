@@ -12,6 +12,7 @@
 #include <string.h>
 #include "../Hardware/hardware.h"
 #include "../Lighting/lighting.h"
+#include "../Telemetry/telemetry.h"
 #if FEATURE_AUDIO_OUTPUT
 #include "../Audio/audio.h"
 #endif
@@ -23,26 +24,103 @@
 typedef struct
 {
     bool initialized;
-    uint32_t last_update_time;
-    uint16_t baseline;
+    uint16_t baseline;           // Tracked idle level in ADC counts (integer part of baseline_q16)
+    uint32_t baseline_q16;       // Slow baseline tracker, ADC counts << 16
+    uint32_t envelope_q16;       // Fast peak envelope of the deviation above baseline, ADC counts << 16
+    bool baseline_reseed;        // Take the next sample as the new baseline
     uint16_t light_threshold;
     uint16_t strong_threshold;
-    uint32_t update_interval_ms;
     uint16_t current_raw;
     uint16_t breath_intensity;
-    uint32_t strong_threshold_start_time;
-    bool strong_threshold_active;
+    uint32_t strong_threshold_start_time; // Start of the current strong blow (or of its last effect switch)
+    bool strong_threshold_active;         // Envelope above the strong threshold - a blow is in progress
     
     // Consecutive strong breath detection
     uint8_t strong_breath_count;  // Count of consecutive readings above strong threshold
+    bool stop_armed;              // Envelope fell to the strong threshold since the trigger - a new blow may stop the song
+
+    uint32_t last_activity_time;  // Last breath, song or cooldown (standby inactivity timer)
 
-    // Post-song cooldown to prevent immediate re-triggering
-    uint32_t song_cooldown_end_time; // When cooldown period ends
-    bool in_song_cooldown;           // Whether we're in cooldown period
 } sensors_state_t;
 
 static sensors_state_t g_sensors_state;
 
+// ============================================================================
+// PRIVATE HELPER FUNCTIONS
+// ============================================================================
+
+// Feed one ADC sample through the baseline tracker and the envelope detector
+// O(1), shifts and compares only - no division
+static void sensors_process_sample(uint16_t sample)
+{
+    uint32_t x = (uint32_t)sample << 16;
+
+    if (g_sensors_state.baseline_reseed)
+    {
+        g_sensors_state.baseline_q16 = x;
+        g_sensors_state.envelope_q16 = 0;
+        g_sensors_state.baseline_reseed = false;
+        return;
+    }
+
+    uint32_t baseline = g_sensors_state.baseline_q16;
+    uint32_t envelope = g_sensors_state.envelope_q16;
+
+    // Envelope: fast attack / slow decay on the positive deviation from the baseline
+    uint32_t deviation = (x > baseline) ? (x - baseline) : 0;
+    if (deviation > envelope)
+    {
+        envelope += (deviation - envelope) >> SENSORS_ENVELOPE_ATTACK_SHIFT;
+    }
+    else
+    {
+        envelope -= (envelope - deviation) >> SENSORS_ENVELOPE_DECAY_SHIFT;
+    }
+
+    // Baseline: falls fast, rises slowly - and much slower while a breath is in progress
+    if (x < baseline)
+    {
+        baseline -= (baseline - x) >> SENSORS_BASELINE_FALL_SHIFT;
+    }
+    else if (envelope > ((uint32_t)g_sensors_state.light_threshold << 16))
+    {
+        baseline += (x - baseline) >> SENSORS_BASELINE_HOLD_SHIFT;
+    }
+    else
+    {
+        baseline += (x - baseline) >> SENSORS_BASELINE_RISE_SHIFT;
+    }
+
+    g_sensors_state.baseline_q16 = baseline;
+    g_sensors_state.envelope_q16 = envelope;
+}
+
+#if LIGHTING_EFFECTS_ENABLED > 1
+// A strong blow held for BREATH_LONG_BLOW_MS cycles the lighting effect, holding on moves on again
+// Tracked through songs and the cooldown - the short-blow song trigger fires at the onset either way
+static void sensors_track_long_blow(uint16_t envelope)
+{
+    if (envelope <= g_sensors_state.strong_threshold)
+    {
+        g_sensors_state.strong_threshold_active = false;
+        return;
+    }
+
+    uint32_t now = hardware_get_millis();
+    if (!g_sensors_state.strong_threshold_active)
+    {
+        g_sensors_state.strong_threshold_active = true;
+        g_sensors_state.strong_threshold_start_time = now;
+    }
+    else if (now - g_sensors_state.strong_threshold_start_time >= BREATH_LONG_BLOW_MS)
+    {
+        lighting_next_effect(); // Shows once the song started by the blow is over
+        TELEM_EVENT(TELEMETRY_EVENT_EFFECT_SWITCH);
+        g_sensors_state.strong_threshold_start_time = now;
+    }
+}
+#endif
+
 // ============================================================================
 // PUBLIC FUNCTIONS
 // ============================================================================
@@ -51,15 +129,13 @@ bool sensors_init(void)
 {
     memset(&g_sensors_state, 0, sizeof(g_sensors_state));
 
-    // Initialize hardware microphone
-    hardware_microphone_init();
+    // The ADC and PB3 are set up once by hardware_init() - samples are already queued
 
     // Set default values
     g_sensors_state.baseline = 0; // Will be set by calibration
     g_sensors_state.light_threshold = BREATH_LIGHT_THRESHOLD;
     g_sensors_state.strong_threshold = BREATH_STRONG_THRESHOLD;
-    g_sensors_state.update_interval_ms = SENSOR_UPDATE_RATE_MS;  // Configurable update rate
-    g_sensors_state.last_update_time = hardware_get_millis();
+    g_sensors_state.last_activity_time = hardware_get_millis();
 
 #if FEATURE_AUDIO_OUTPUT
     // Note: Now using rotating song system for strong breath triggers
@@ -80,34 +156,87 @@ void sensors_update(void)
         return;
     }
 
-    uint32_t current_time = hardware_get_millis();
+    // Called once per SENSOR_UPDATE_RATE_MS by the scheduler
 
-    // Check update interval
-    if (current_time - g_sensors_state.last_update_time < g_sensors_state.update_interval_ms)
+    uint16_t sample;
+    bool have_samples = false;
+#if FEATURE_MIC_ADC_NOISE_REDUCTION
+    // One clean conversion per decision, taken in ADC noise reduction sleep
+    if (hardware_microphone_sample_quiet(&sample))
     {
-        return;
+        sensors_process_sample(sample);
+        g_sensors_state.current_raw = sample;
+        have_samples = true;
+        TELEM_SAMPLE(sample);
+    }
+#else
+    // Drain the samples queued by the ADC ISR since the last update through the detector
+    while (hardware_microphone_pop(&sample))
+    {
+        sensors_process_sample(sample);
+        g_sensors_state.current_raw = sample;
+        have_samples = true;
+        TELEM_SAMPLE(sample);
+    }
+#endif
+
+    if (!have_samples)
+    {
+        return; // No sampling window since the last update (LED_3ER lit all the time)
     }
 
-    g_sensors_state.last_update_time = current_time;
+    // Breath level = envelope above the tracked baseline (integer ADC counts)
+    uint16_t envelope = (uint16_t)(g_sensors_state.envelope_q16 >> 16);
+    g_sensors_state.baseline = (uint16_t)(g_sensors_state.baseline_q16 >> 16);
+    g_sensors_state.breath_intensity = (envelope > g_sensors_state.light_threshold) ? envelope : 0;
+    TELEM_DETECTOR(g_sensors_state.baseline, envelope);
 
-    // SIMPLIFIED: Basic breath detection with fixed baseline
-    uint16_t raw_value = hardware_microphone_read();
-    g_sensors_state.current_raw = raw_value;
+    if (g_sensors_state.breath_intensity || audio_is_song_playing() || !audio_is_cooldown_expired())
+    {
+        g_sensors_state.last_activity_time = hardware_get_millis(); // Long interval - full millis
+    }
 
-    // Simple fixed threshold detection (no complex baseline tracking)
-    uint16_t breath_threshold = g_sensors_state.baseline + g_sensors_state.light_threshold;
-    uint16_t strong_threshold = g_sensors_state.baseline + g_sensors_state.strong_threshold;
+#if LIGHTING_EFFECTS_ENABLED > 1
+    sensors_track_long_blow(envelope);
+#endif
 
-    if (raw_value > strong_threshold)
+    // Post-song cooldown: keep tracking, but no triggers or candle boost
+    if (!audio_is_song_playing() && !audio_is_cooldown_expired())
+    {
+        g_sensors_state.strong_breath_count = 0;
+        lighting_set_breath_boost(0);
+        return;
+    }
+
+    if (envelope > g_sensors_state.strong_threshold)
     {
         // Strong breath detected - increment consecutive count
         g_sensors_state.strong_breath_count++;
         
+        // A new blow during a song stops it (needs a longer run while the buzzer is active)
+        // The blow that started the song keeps counting until it ends - it must not stop it
+        if (audio_is_song_playing())
+        {
+            if (!g_sensors_state.stop_armed)
+            {
+                g_sensors_state.strong_breath_count = 0;
+            }
+            else if (g_sensors_state.strong_breath_count >= BREATH_STOP_MIN_DURATION)
+            {
+                audio_stop_melody();
+                TELEM_EVENT(TELEMETRY_EVENT_SONG_STOP);
+                g_sensors_state.strong_breath_count = 0;
+            }
+            return;
+        }
+
         // Trigger song only after required consecutive readings
         if (g_sensors_state.strong_breath_count >= BREATH_STRONG_MIN_DURATION)
         {
             audio_play_next_melody();
+            TELEM_EVENT(TELEMETRY_EVENT_SONG_START);
             g_sensors_state.strong_breath_count = 0;  // Reset count after triggering
+            g_sensors_state.stop_armed = false;       // Re-armed once this blow is over
         }
         return;
     }
@@ -115,17 +244,18 @@ void sensors_update(void)
     {
         // Not above strong threshold - reset consecutive count
         g_sensors_state.strong_breath_count = 0;
+        g_sensors_state.stop_armed = true;
         
-        if (raw_value > breath_threshold)
+        if (envelope > g_sensors_state.light_threshold)
         {
             // Light breath - candle effect
-            uint8_t boost = ((raw_value - breath_threshold) * 50) / g_sensors_state.light_threshold;
-            lighting_set_candle_intensity_boost(boost > 50 ? 50 : boost);
+            uint16_t boost = ((uint32_t)(envelope - g_sensors_state.light_threshold) * 50) / g_sensors_state.light_threshold;
+            lighting_set_breath_boost(boost > 50 ? 50 : boost);
         }
         else
         {
             // No breath - normal candle
-            lighting_set_candle_intensity_boost(0);
+            lighting_set_breath_boost(0);
         }
     }
 }
@@ -142,19 +272,47 @@ uint16_t sensors_get_raw_value(void)
 
 uint16_t sensors_get_mean_value(void)
 {
-    return g_sensors_state.current_raw; // Simplified - no buffering
+    return g_sensors_state.baseline; // Tracked idle level
 }
 
 void sensors_calibrate(bool force_immediate)
 {
-    (void)force_immediate; // Suppress unused parameter warning
-    // SIMPLIFIED: Fixed baseline approach - eliminates all calibration complexity
-    g_sensors_state.baseline = 200; // Reasonable fixed value - adjust if needed
+    if (force_immediate)
+    {
+        // Restart tracking from the next sample
+        g_sensors_state.baseline_reseed = true;
+        return;
+    }
+
+    // Seed the tracker - it adapts to the real idle level within a fraction of a second
+    g_sensors_state.baseline = SENSORS_BASELINE_INITIAL;
+    g_sensors_state.baseline_q16 = (uint32_t)SENSORS_BASELINE_INITIAL << 16;
+    g_sensors_state.envelope_q16 = 0;
+}
+
+uint32_t sensors_get_last_activity_time(void)
+{
+    return g_sensors_state.last_activity_time;
+}
+
+uint16_t sensors_get_wake_level(void)
+{
+    // The baseline was tracked with the LEDs running - a one-count strong threshold would wake on noise
+    uint16_t margin = (g_sensors_state.strong_threshold > STANDBY_WAKE_MARGIN) ? g_sensors_state.strong_threshold : STANDBY_WAKE_MARGIN;
+    return g_sensors_state.baseline + margin;
+}
+
+void sensors_notify_wake(void)
+{
+    // Stay awake for the grace period only - a breath seen by sensors_update() restarts the full timeout
+    uint32_t timeout_ms = (uint32_t)STANDBY_TIMEOUT_S * 1000;
+    uint32_t credit_ms = (timeout_ms > STANDBY_WAKE_GRACE_MS) ? timeout_ms - STANDBY_WAKE_GRACE_MS : 0;
+    g_sensors_state.last_activity_time = hardware_get_millis() - credit_ms;
 }
 
 void sensors_force_recalibration(void)
 {
-    // Wrapper for immediate calibration after audio events
+    // Wrapper for immediate calibration (baseline re-seeded from the next sample)
     sensors_calibrate(true);
 }
 
@@ -28,12 +28,25 @@ extern "C"
     // ============================================================================
 
 // Configurable sensor parameters
-#define SENSORS_BUFFER_SIZE 16                // Smaller buffer for mean calculation
 #define SENSORS_DEFAULT_UPDATE_INTERVAL_MS 10 // Default update interval
 
+// Streaming breath detector (per queued ADC sample, ~1kHz) - shift-based IIR filters, Q16 fixed point
+// Noise reduction sampling delivers one sample per update (~200Hz): shifts shrink to keep the time constants
+#if FEATURE_MIC_ADC_NOISE_REDUCTION
+#define SENSORS_RATE_SHIFT 2
+#else
+#define SENSORS_RATE_SHIFT 0
+#endif
+#define SENSORS_BASELINE_INITIAL 200      // Seed for the baseline tracker (ADC counts, idle peak detector level)
+#define SENSORS_BASELINE_RISE_SHIFT (8 - SENSORS_RATE_SHIFT)   // Baseline follows rising input over ~0.25s
+#define SENSORS_BASELINE_HOLD_SHIFT (10 - SENSORS_RATE_SHIFT)  // ...over ~1s while a breath is detected (keeps blows, absorbs steps)
+#define SENSORS_BASELINE_FALL_SHIFT (4 - SENSORS_RATE_SHIFT)   // Falls quickly with the peak detector discharge
+#define SENSORS_ENVELOPE_ATTACK_SHIFT 1                        // Envelope rises within a few samples
+#define SENSORS_ENVELOPE_DECAY_SHIFT (5 - SENSORS_RATE_SHIFT)  // ...and decays over ~32ms
+
 // Breath detection thresholds (for electret mic + peak detector circuit)
 // Use configurable values from config.h for adjustable sensitivity
-// Note: Baseline is now dynamically calibrated - no static define needed
+// Note: Thresholds are envelope levels above the tracked baseline
 #define BREATH_THRESHOLD_START BREATH_LIGHT_THRESHOLD   // Light breath - capacitor voltage for gentle blow
 #define BREATH_THRESHOLD_STRONG BREATH_STRONG_THRESHOLD // Strong breath - capacitor voltage for strong blow    // ============================================================================
     // SENSOR DATA STRUCTURES
@@ -66,6 +79,11 @@ extern "C"
     bool sensors_is_breath_detected(void);
     uint8_t sensors_get_breath_intensity(void);
 
+    // Standby support
+    uint32_t sensors_get_last_activity_time(void); // hardware_get_millis() of the last breath, song or cooldown
+    uint16_t sensors_get_wake_level(void);         // Raw ADC sniff level that wakes from standby (baseline + wake margin)
+    void sensors_notify_wake(void);                // After standby: back to sleep in STANDBY_WAKE_GRACE_MS unless a breath follows
+
 #ifdef __cplusplus
 }
 #endif
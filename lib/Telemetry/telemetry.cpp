@@ -0,0 +1,136 @@
+/*
+ * telemetry.cpp - Soft-UART detector telemetry for BlinkyTree (debug builds)
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ *
+ * Collects ADC samples, detector state, events and loop load, queues one frame per period
+ */
+
+#include "telemetry.h"
+#include <string.h>
+
+#if TELEM_ENABLED
+
+#define TELEMETRY_SAMPLE_BYTES ((TELEMETRY_MAX_SAMPLES * 10 + 7) / 8)
+
+// Loop stamps to TELEMETRY_CYCLE_UNIT: HW PWM stamps count CPU cycles, the others CK/64 clocks
+#define TELEMETRY_STAMP_SHIFT ((HARDWARE_STAMP_CYCLES == 1) ? 6 : 0)
+
+// ============================================================================
+// PRIVATE VARIABLES
+// ============================================================================
+
+typedef struct
+{
+    uint8_t sequence;
+    uint8_t sample_count;
+    uint8_t samples[TELEMETRY_SAMPLE_BYTES]; // 10-bit samples packed LSB first
+    uint8_t events;
+    uint16_t baseline;
+    uint16_t envelope;
+
+    // Scheduler load since the last frame
+    uint16_t pass_start; // hardware_get_cycle_stamp() of the running pass
+    uint8_t passes;
+    uint16_t pass_max;
+    uint16_t busy_total;
+} telemetry_state_t;
+
+static telemetry_state_t g_telemetry_state;
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void telemetry_init(void)
+{
+    memset(&g_telemetry_state, 0, sizeof(g_telemetry_state));
+}
+
+void telemetry_sample(uint16_t sample)
+{
+    uint8_t count = g_telemetry_state.sample_count;
+    if (count >= TELEMETRY_MAX_SAMPLES)
+    {
+        g_telemetry_state.events |= TELEMETRY_EVENT_SAMPLES_LOST;
+        return;
+    }
+
+    // Bit offset count * 10 shifts by 0, 2, 4 or 6 - the sample always fits two bytes
+    uint16_t bit = (uint16_t)count * 10;
+    uint8_t *bytes = &g_telemetry_state.samples[bit >> 3];
+    uint16_t value = (sample & 0x3FF) << (bit & 7);
+    bytes[0] |= (uint8_t)value;
+    bytes[1] |= (uint8_t)(value >> 8);
+    g_telemetry_state.sample_count = count + 1;
+}
+
+void telemetry_detector(uint16_t baseline, uint16_t envelope)
+{
+    g_telemetry_state.baseline = baseline;
+    g_telemetry_state.envelope = envelope;
+}
+
+void telemetry_event(uint8_t event)
+{
+    g_telemetry_state.events |= event;
+}
+
+void telemetry_loop_begin(void)
+{
+    g_telemetry_state.pass_start = hardware_get_cycle_stamp();
+}
+
+void telemetry_loop_end(void)
+{
+    uint16_t busy = (uint16_t)(hardware_get_cycle_stamp() - g_telemetry_state.pass_start) >> TELEMETRY_STAMP_SHIFT;
+
+    if (g_telemetry_state.passes < UINT8_MAX)
+        g_telemetry_state.passes++;
+    if (busy > g_telemetry_state.pass_max)
+        g_telemetry_state.pass_max = busy;
+    g_telemetry_state.busy_total = (g_telemetry_state.busy_total > UINT16_MAX - busy) ? UINT16_MAX : g_telemetry_state.busy_total + busy;
+}
+
+void telemetry_update(void)
+{
+    uint8_t frame[TELEMETRY_FRAME_MAX];
+    uint8_t sample_bytes = ((uint16_t)g_telemetry_state.sample_count * 10 + 7) / 8;
+    uint8_t length = TELEMETRY_HEADER_SIZE + sample_bytes;
+
+    frame[0] = TELEMETRY_SYNC;
+    frame[1] = g_telemetry_state.sequence++;
+    frame[2] = g_telemetry_state.sample_count;
+    frame[3] = g_telemetry_state.events;
+    frame[4] = (uint8_t)g_telemetry_state.baseline;
+    frame[5] = (uint8_t)(g_telemetry_state.baseline >> 8);
+    frame[6] = (uint8_t)g_telemetry_state.envelope;
+    frame[7] = (uint8_t)(g_telemetry_state.envelope >> 8);
+    frame[8] = g_telemetry_state.passes;
+    frame[9] = (uint8_t)g_telemetry_state.pass_max;
+    frame[10] = (uint8_t)(g_telemetry_state.pass_max >> 8);
+    frame[11] = (uint8_t)g_telemetry_state.busy_total;
+    frame[12] = (uint8_t)(g_telemetry_state.busy_total >> 8);
+    memcpy(&frame[TELEMETRY_HEADER_SIZE], g_telemetry_state.samples, sample_bytes);
+
+    uint8_t checksum = 0;
+    for (uint8_t i = 1; i < length; i++)
+    {
+        checksum += frame[i];
+    }
+    frame[length++] = checksum;
+
+    // A full queue drops the frame - the sequence number still advances so the host sees the gap
+    hardware_telemetry_write(frame, length);
+
+    g_telemetry_state.sample_count = 0;
+    memset(g_telemetry_state.samples, 0, sizeof(g_telemetry_state.samples));
+    g_telemetry_state.events = 0;
+    g_telemetry_state.passes = 0;
+    g_telemetry_state.pass_max = 0;
+    g_telemetry_state.busy_total = 0;
+}
+
+#endif // TELEM_ENABLED
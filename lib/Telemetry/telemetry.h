@@ -0,0 +1,81 @@
+/*
+ * telemetry.h - Soft-UART detector telemetry for BlinkyTree (debug builds)
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../../config/config.h"
+#include "../Hardware/hardware.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // ============================================================================
+    // FRAME FORMAT
+    // ============================================================================
+
+    // One frame per TELEMETRY_FRAME_MS, multi-byte fields little-endian (scripts/read_telemetry.py):
+    //   0      TELEMETRY_SYNC
+    //   1      sequence number (a gap = frames dropped while the TX queue was full)
+    //   2      sample count n (0..TELEMETRY_MAX_SAMPLES)
+    //   3      TELEMETRY_EVENT_* bits since the previous frame
+    //   4-5    baseline, ADC counts (last sensors_update)
+    //   6-7    envelope above the baseline, ADC counts
+    //   8      scheduler passes
+    //   9-10   longest pass, TELEMETRY_CYCLE_UNIT CPU cycles
+    //   11-12  busy time of all passes, TELEMETRY_CYCLE_UNIT CPU cycles
+    //   13..   n raw ADC samples, 10 bits each packed LSB first (ceil(n * 10 / 8) bytes)
+    //   last   checksum - sum of bytes 1 to the one before it, modulo 256
+#define TELEMETRY_HEADER_SIZE 13
+#define TELEMETRY_FRAME_MAX (TELEMETRY_HEADER_SIZE + (TELEMETRY_MAX_SAMPLES * 10 + 7) / 8 + 1)
+#define TELEMETRY_CYCLE_UNIT 64 // Loop times in Timer0 CK/64 clocks (8us at 8MHz) in every PWM engine mode
+
+#define TELEMETRY_EVENT_SONG_START 0x01    // Strong blow started a song
+#define TELEMETRY_EVENT_SONG_STOP 0x02     // Blow during a song stopped it
+#define TELEMETRY_EVENT_EFFECT_SWITCH 0x04 // Long blow switched the lighting effect
+#define TELEMETRY_EVENT_SAMPLES_LOST 0x08  // More than TELEMETRY_MAX_SAMPLES samples in the frame period
+
+#if TELEMETRY_FRAME_MAX >= TELEMETRY_TX_BUFFER_SIZE
+#error "TELEMETRY_TX_BUFFER_SIZE must hold a full telemetry frame"
+#endif
+
+    // ============================================================================
+    // PROBES
+    // ============================================================================
+
+#if TELEM_ENABLED
+#define TELEM_SAMPLE(sample) telemetry_sample(sample)
+#define TELEM_DETECTOR(baseline, envelope) telemetry_detector((baseline), (envelope))
+#define TELEM_EVENT(event) telemetry_event(event)
+#define TELEM_LOOP_BEGIN() telemetry_loop_begin()
+#define TELEM_LOOP_END() telemetry_loop_end()
+
+    void telemetry_init(void);
+    void telemetry_sample(uint16_t sample);                     // Raw ADC sample, as sensors_update() takes it from the queue
+    void telemetry_detector(uint16_t baseline, uint16_t envelope); // Detector state after a sensors_update()
+    void telemetry_event(uint8_t event);                        // TELEMETRY_EVENT_* bits
+    void telemetry_loop_begin(void);                            // Scheduler pass starts running tasks
+    void telemetry_loop_end(void);                              // ...and is about to sleep
+    void telemetry_update(void);                                // Queue one frame - scheduler task every TELEMETRY_FRAME_MS
+#else
+#define TELEM_SAMPLE(sample)
+#define TELEM_DETECTOR(baseline, envelope)
+#define TELEM_EVENT(event)
+#define TELEM_LOOP_BEGIN()
+#define TELEM_LOOP_END()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_H_
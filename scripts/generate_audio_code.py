@@ -9,26 +9,54 @@ Licensed under CC-BY-NC 4.0
 
 import os
 import sys
+import math
+import struct
+import argparse
 import yaml
 import xml.etree.ElementTree as ET
+from collections import Counter
+from functools import reduce
 from pathlib import Path
 from typing import List, Dict, Tuple, Optional
 
-# Note frequency mapping (from audio.h - fine-tuned for ATtiny85 buzzer)
-NOTE_FREQUENCIES = {
-    'C': {3: 131, 4: 172, 5: 344, 6: 690},
-    'CS': {3: 139, 4: 182, 5: 365, 6: 730},
-    'D': {3: 147, 4: 192, 5: 386, 6: 773},
-    'DS': {3: 156, 4: 204, 5: 408, 6: 818},
-    'E': {3: 165, 4: 216, 5: 433, 6: 866},
-    'F': {3: 175, 4: 229, 5: 459, 6: 918},
-    'FS': {3: 185, 4: 243, 5: 486, 6: 972},
-    'G': {3: 128, 4: 257, 5: 515, 6: 1030},
-    'GS': {3: 136, 4: 273, 5: 546, 6: 1092},
-    'A': {3: 144, 4: 290, 5: 580, 6: 1160},
-    'AS': {3: 153, 4: 307, 5: 614, 6: 1228},
-    'B': {3: 162, 4: 326, 5: 652, 6: 0},
+# Pitch index mapping (must match audio_pitch_frequencies[] in audio.cpp and the generated pitch tables)
+# Index 0 = G3 (NOTE_G3) ... index 39 = AS6 (NOTE_AS6), one semitone per step
+NOTE_SEMITONES = {
+    'C': 0, 'CS': 1, 'D': 2, 'DS': 3, 'E': 4, 'F': 5,
+    'FS': 6, 'G': 7, 'GS': 8, 'A': 9, 'AS': 10, 'B': 11,
 }
+PITCH_BASE_MIDI = 55  # G3
+PITCH_COUNT = 40      # G3 .. AS6
+PITCH_REST = 63       # Rest marker in the packed format (AUDIO_PITCH_REST)
+PITCH_NAMES = [name for octave in (3, 4, 5, 6) for name in
+               (f'{n}{octave}' for n in NOTE_SEMITONES)][7:7 + PITCH_COUNT]
+
+# Packed note byte: bits 7-6 duration code, bits 5-0 pitch index (see audio.h)
+DURATION_CODE_EXPLICIT = 3  # Tick count follows in the next byte
+MAX_TICKS = 255
+CODE_SEGMENT_CALL = 0x3E    # AUDIO_PITCH_SEGMENT: play shared segment (index in next byte)
+CODE_SEGMENT_RETURN = 0x3D  # AUDIO_PITCH_RETURN: end of a shared segment
+MAX_SEGMENTS = 256
+SEGMENT_OVERHEAD = 3        # Return marker + uint16 offset table entry
+DESCRIPTOR_SIZE = 11        # sizeof(audio_song_t) on AVR
+DDS_DESCRIPTOR_SIZE = 14    # ...with the FEATURE_AUDIO_DDS harmony pointer and count
+
+# Pitch tables (equal temperament, A4 = MIDI 69 = 440 Hz) for the Timer1 tone and the DDS voices
+DEFAULT_F_CPU = 8000000     # board_build.f_cpu in platformio.ini
+TIMER1_CLOCK_SELECTS = 15   # CS13:0 = 1 (CK/1) ... 15 (CK/16384)
+DDS_SAMPLE_DIVIDER = 256    # AUDIO_DDS_SAMPLE_RATE = F_CPU / 256 (hardware.h)
+
+# Flash budget defaults (config.yaml flash_budget section)
+DEFAULT_FLASH_SIZE = 8192   # ATtiny85 program memory
+DEFAULT_FLASH_RESERVE = 128 # Kept free: get_melody_data() cases, small code changes
+DEFAULT_PRIORITY = 0
+SONG_SYMBOL_PREFIXES = ('melody_', 'audio_segment_')  # Generated PROGMEM data in firmware.elf
+
+# Per-song playback defaults and limits (baked into the song data)
+DEFAULT_DUTY_CYCLE = 75
+DEFAULT_SPEED = 100
+DEFAULT_TRANSPOSE = 0
+DEFAULT_NOTE_GAP_MS = 50
 
 # Duration constants from audio.h
 SIXTEENTH_NOTE = 125
@@ -49,10 +77,18 @@ class MusicXMLParser:
         
     def parse(self) -> List[Tuple[int, int]]:
         """
-        Parse MusicXML and return list of (frequency, duration) tuples
-        Returns: List of (frequency_hz, duration_ms) tuples
+        Parse MusicXML and return list of (pitch, duration) tuples
+        Returns: List of (pitch_index, duration_ms) tuples (PITCH_REST for rests)
         """
-        notes = []
+        return self.parse_voices()[0]
+
+    def parse_voices(self) -> Tuple[List[Tuple[int, int]], List[Tuple[int, int]]]:
+        """
+        Parse MusicXML into (melody, harmony) lists of (pitch_index, duration_ms) tuples
+        Melody = first voice on staff 1, harmony = the next voice or staff (e.g. the bass clef
+        of a piano score) for the DDS engine. A harmony line of rests only comes back empty.
+        """
+        voices = {}
         
         # Find all measures
         for measure in self.root.findall('.//measure'):
@@ -61,10 +97,11 @@ class MusicXMLParser:
             if divisions_elem is not None:
                 self.divisions = int(divisions_elem.text)
             
-            # Process all notes in measure
+            # Process all notes in measure, each voice into its own line
             for note in measure.findall('.//note'):
                 freq, duration = self._parse_note(note)
                 if freq is not None and duration is not None:
+                    notes = voices.setdefault(self._voice_key(note), [])
                     # Check if this note is tied to the previous note
                     tie = note.find('tie')
                     if tie is not None and tie.get('type') == 'start':
@@ -83,19 +120,25 @@ class MusicXMLParser:
                         # No tie - normal note
                         notes.append((freq, duration))
         
-        return notes
+        # Voices in order of appearance: melody on staff 1, harmony from the next one
+        keys = list(voices)
+        melody_key = next((key for key in keys if key[0] == '1'), keys[0] if keys else None)
+        melody = voices.get(melody_key, [])
+        harmony = next((voices[key] for key in keys if key != melody_key), [])
+        if all(pitch == PITCH_REST for pitch, _ in harmony):
+            harmony = []
+        return melody, harmony
+
+    def _voice_key(self, note_elem) -> Tuple[str, str]:
+        """(staff, voice) a note belongs to - both default to 1"""
+        return (note_elem.findtext('staff', '1').strip(), note_elem.findtext('voice', '1').strip())
     
     def _parse_note(self, note_elem) -> Tuple[Optional[int], Optional[int]]:
         """Parse a single note element"""
-        # Skip notes from staves other than 1 (bass clef in piano arrangements)
-        staff_elem = note_elem.find('staff')
-        if staff_elem is not None and int(staff_elem.text) != 1:
-            return (None, None)
-        
         # Check if it's a rest
         if note_elem.find('rest') is not None:
             duration = self._get_duration(note_elem)
-            return (0, duration)  # 0 frequency = rest
+            return (PITCH_REST, duration)
         
         # Get pitch
         pitch_elem = note_elem.find('pitch')
@@ -115,16 +158,26 @@ class MusicXMLParser:
             elif alter_val == -1:  # Flat - convert to equivalent sharp
                 note_name = self._flat_to_sharp(step)
         
-        # Get frequency
-        freq = NOTE_FREQUENCIES.get(note_name, {}).get(octave, 0)
-        if freq == 0:
+        # Get pitch index into the firmware note table
+        pitch = self._pitch_index(note_name, octave)
+        if pitch is None:
             print(f"Warning: Unknown note {note_name}{octave} in {self.filepath.name}", file=sys.stderr)
             return (None, None)
         
         # Get duration
         duration = self._get_duration(note_elem)
         
-        return (freq, duration)
+        return (pitch, duration)
+    
+    def _pitch_index(self, note_name: str, octave: int) -> Optional[int]:
+        """Map a note name to its pitch index (None if outside G3..AS6)"""
+        semitone = NOTE_SEMITONES.get(note_name)
+        if semitone is None:
+            return None
+        index = 12 * (octave + 1) + semitone - PITCH_BASE_MIDI
+        if 0 <= index < PITCH_COUNT:
+            return index
+        return None
     
     def _get_duration(self, note_elem) -> int:
         """Calculate note duration in milliseconds"""
@@ -170,6 +223,121 @@ def sanitize_identifier(name: str) -> str:
     return name.upper()
 
 
+def resolve_song_priority(config: Dict, song_name: str) -> int:
+    """Packing priority from config.yaml - higher is kept first when flash runs short"""
+    return config.get('songs', {}).get(song_name, {}).get('priority', DEFAULT_PRIORITY)
+
+
+def is_song_enabled(config: Dict, song_name: str) -> bool:
+    """Songs are enabled unless config.yaml sets enabled: false"""
+    return config.get('songs', {}).get(song_name, {}).get('enabled', True)
+
+
+def read_elf_flash_usage(elf_path: Path) -> Optional[Tuple[int, int]]:
+    """
+    Flash bytes of a linked AVR image: (.text + .data, generated song data in it)
+    Reads the ELF32 section and symbol tables directly - no binutils needed
+    """
+    try:
+        data = elf_path.read_bytes()
+    except OSError:
+        return None
+    if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+        return None  # Not a 32-bit little-endian ELF (AVR)
+
+    shoff, = struct.unpack_from('<I', data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from('<HHH', data, 0x2E)
+    sections = [struct.unpack_from('<IIIIIIIIII', data, shoff + i * shentsize) for i in range(shnum)]
+
+    def section_name(index, section):
+        names_offset = sections[index][4]
+        start = names_offset + section[0]
+        return data[start:data.index(b'\0', start)].decode()
+
+    image_bytes, song_bytes = 0, 0
+    for section in sections:
+        name = section_name(shstrndx, section)
+        if name in ('.text', '.data'):
+            image_bytes += section[5]
+        elif section[1] == 2:  # SHT_SYMTAB
+            strtab_offset = sections[section[6]][4]
+            for offset in range(section[4], section[4] + section[5], 16):
+                st_name, _, st_size = struct.unpack_from('<III', data, offset)
+                start = strtab_offset + st_name
+                symbol = data[start:data.index(b'\0', start)].decode(errors='replace')
+                if symbol.startswith(SONG_SYMBOL_PREFIXES):
+                    song_bytes += st_size
+    return image_bytes, song_bytes
+
+
+def resolve_song_budget(config: Dict, elf_path: Optional[Path]) -> Tuple[Optional[int], str]:
+    """
+    Flash bytes available for song data: flash_size - reserve - firmware code without songs
+    code_size: auto measures the code from the last build's firmware.elf (None = no build yet)
+    """
+    budget = config.get('flash_budget', {})
+    flash_size = budget.get('flash_size', DEFAULT_FLASH_SIZE)
+    reserve = budget.get('reserve', DEFAULT_FLASH_RESERVE)
+    code_size = budget.get('code_size', 'auto')
+
+    if code_size == 'auto':
+        usage = read_elf_flash_usage(elf_path) if elf_path else None
+        if usage is None:
+            return None, "no firmware.elf to measure yet - budget applies from the next build"
+        image_bytes, song_bytes = usage
+        code_size = image_bytes - song_bytes
+        source = f"{code_size} bytes code measured in {elf_path.name}"
+    else:
+        source = f"{code_size} bytes code from config.yaml"
+
+    return flash_size - reserve - code_size, f"{flash_size} flash - {reserve} reserve - {source}"
+
+
+def descriptor_size(dds: bool) -> int:
+    """PROGMEM bytes of one audio_song_t in the targeted build"""
+    return DDS_DESCRIPTOR_SIZE if dds else DESCRIPTOR_SIZE
+
+
+def pack_song_set(packed_songs: Dict, song_names: List[str], test_tone: Dict,
+                  dds: bool) -> Tuple[Dict, Dict, List, int]:
+    """
+    Share phrases across the chosen songs: (streams, harmony streams, segments, PROGMEM bytes incl. test tone)
+    Harmony streams join the sharing only for DDS builds, they are compiled out otherwise
+    """
+    voices = {(song_name, 'encoded'): list(packed_songs[song_name]['encoded']) for song_name in song_names}
+    if dds:
+        voices.update({(song_name, 'harmony'): list(packed_songs[song_name]['harmony'])
+                       for song_name in song_names if packed_songs[song_name]['harmony']})
+    segments = find_segments(voices)
+    streams = {song_name: voices[(song_name, 'encoded')] for song_name in song_names}
+    harmonies = {song_name: stream for (song_name, voice), stream in voices.items() if voice == 'harmony'}
+    total = sum(stream_size(stream) for stream in voices.values()) + len(streams) * descriptor_size(dds)
+    total += sum(stream_size(segment) + SEGMENT_OVERHEAD for segment in segments)
+    total += test_tone['size'] + descriptor_size(dds)
+    return streams, harmonies, segments, total
+
+
+def fit_songs(config: Dict, packed_songs: Dict, test_tone: Dict, budget: Optional[int],
+              dds: bool) -> Tuple[List[str], List[str]]:
+    """
+    Enabled songs by priority (ties keep file order), each kept only if the set still fits
+    Returns (kept songs in rotation order, songs dropped for flash)
+    """
+    candidates = [song_name for song_name in packed_songs if is_song_enabled(config, song_name)]
+    candidates.sort(key=lambda song_name: -resolve_song_priority(config, song_name))
+    if budget is None:
+        return candidates, []
+
+    kept, dropped = [], []
+    for song_name in candidates:
+        _, _, _, total = pack_song_set(packed_songs, kept + [song_name], test_tone, dds)
+        if total <= budget:
+            kept.append(song_name)
+        else:
+            dropped.append(song_name)
+    return kept, dropped
+
+
 def generate_melody_enum(songs: Dict) -> str:
     """Generate melody_id_t enum"""
     lines = [
@@ -189,19 +357,279 @@ def generate_melody_enum(songs: Dict) -> str:
     return '\n'.join(lines)
 
 
-def generate_song_data(song_name: str, notes: List[Tuple[int, int]]) -> str:
-    """Generate C array for a single song"""
+def choose_tick_ms(durations: List[int], song_name: str) -> int:
+    """Pick the per-song duration unit: GCD of all durations, coarsened if ticks overflow a byte"""
+    tick_ms = reduce(math.gcd, durations, 0) or 1
+    max_duration = max(durations)
+    if max_duration // tick_ms > MAX_TICKS:
+        tick_ms = math.ceil(max_duration / MAX_TICKS)
+        print(f"Warning: {song_name} durations quantized to {tick_ms} ms ticks", file=sys.stderr)
+    return tick_ms
+
+
+def resolve_song_config(config: Dict, song_name: str) -> Dict:
+    """Playback settings of a song from config.yaml, defaulted and clamped like the firmware used to"""
+    song_config = config.get('songs', {}).get(song_name, {})
+    return {
+        'duty_cycle': min(100, max(10, song_config.get('duty_cycle', DEFAULT_DUTY_CYCLE))),
+        'speed': min(10000, max(25, song_config.get('speed', DEFAULT_SPEED))),
+        'transpose': min(12, max(-12, song_config.get('transpose', DEFAULT_TRANSPOSE))),
+    }
+
+
+def transpose_pitch(pitch: int, semitones: int) -> int:
+    """Shift a pitch index within the note table (rests unchanged)"""
+    if pitch == PITCH_REST:
+        return pitch
+    return min(PITCH_COUNT - 1, max(0, pitch + semitones))
+
+
+def encode_song(notes: List[Tuple[int, int]], song_name: str, song_config: Dict, note_gap_ms: int,
+                harmony: Optional[List[Tuple[int, int]]] = None) -> Dict:
+    """
+    Encode notes into the packed 1-2 byte format used by the firmware decoder
+    Transposition and speed from config.yaml are applied here, so the firmware plays
+    final pitch indices and tick durations without any runtime scaling.
+    An optional harmony line shares the song's tick unit and duration codes.
+    """
+    harmony = harmony or []
+    notes = [(transpose_pitch(pitch, song_config['transpose']), duration) for pitch, duration in notes]
+    harmony = [(transpose_pitch(pitch, song_config['transpose']), duration) for pitch, duration in harmony]
+    tick_ms = choose_tick_ms([duration for _, duration in notes + harmony], song_name)
+
+    def to_ticks(line):
+        return [min(MAX_TICKS, max(1, int(round(duration / tick_ms)))) for _, duration in line]
+
+    # The three most common melody tick counts get single-byte duration codes
+    ticks = to_ticks(notes)
+    duration_ticks = [t for t, _ in Counter(ticks).most_common(3)]
+    for filler in (1, 2, 4, 8):
+        if len(duration_ticks) >= 3:
+            break
+        if filler not in duration_ticks:
+            duration_ticks.append(filler)
+
+    def encode_line(line, line_ticks):
+        encoded = []
+        for (pitch, _), note_ticks in zip(line, line_ticks):
+            if note_ticks in duration_ticks:
+                code = duration_ticks.index(note_ticks)
+                encoded.append((((code << 6) | pitch,), pitch, note_ticks))
+            else:
+                encoded.append((((DURATION_CODE_EXPLICIT << 6) | pitch, note_ticks), pitch, note_ticks))
+        return encoded
+
+    encoded = encode_line(notes, ticks)
+    harmony_encoded = encode_line(harmony, to_ticks(harmony))
+
+    # Speed only changes the tick unit: tick counts (and shared segments) stay the same
+    return {
+        'tick_ms': max(1, int(round(tick_ms * 100 / song_config['speed']))),
+        'gap_ms': min(255, int(round(note_gap_ms * 100 / song_config['speed']))),
+        'duty_scale': min(255, int(round(song_config['duty_cycle'] * 256 / 100))),
+        'transpose': song_config['transpose'],
+        'duration_ticks': duration_ticks,
+        'encoded': encoded,
+        'size': sum(len(code) for code, _, _ in encoded),
+        'harmony': harmony_encoded,
+    }
+
+
+def pitch_name(pitch: int) -> str:
+    """Readable name of a pitch index for generated comments"""
+    return 'REST' if pitch == PITCH_REST else PITCH_NAMES[pitch]
+
+
+def find_segments(streams: Dict) -> List[List]:
+    """
+    Replace repeated note runs (within and across songs) by shared segment calls
+    Greedy: repeatedly extract the run with the largest flash saving.
+    Rewrites streams in place (calls become ('call', index)) and returns the segments.
+    Runs never contain a call - the player keeps a single return position, segments do not nest.
+    """
+    segments = []
+    while len(segments) < MAX_SEGMENTS:
+        # Collect start positions of every call-free run of at least two notes
+        runs = {}
+        for song_name, stream in streams.items():
+            for start in range(len(stream)):
+                if stream[start][0] == 'call':
+                    continue
+                for end in range(start + 2, len(stream) + 1):
+                    if stream[end - 1][0] == 'call':
+                        break
+                    key = tuple(entry[0] for entry in stream[start:end])
+                    runs.setdefault(key, []).append((song_name, start))
+
+        best_key, best_saving = None, 0
+        for key, positions in runs.items():
+            # Count non-overlapping occurrences
+            uses, last_end = 0, {}
+            for song_name, start in positions:
+                if start >= last_end.get(song_name, 0):
+                    uses += 1
+                    last_end[song_name] = start + len(key)
+            run_bytes = sum(len(code) for code in key)
+            saving = uses * run_bytes - (uses * 2 + run_bytes + SEGMENT_OVERHEAD)
+            if saving > best_saving or (saving == best_saving and best_key and len(key) > len(best_key)):
+                best_key, best_saving = key, saving
+
+        if best_key is None:
+            break
+
+        index = len(segments)
+        segment = None
+        for song_name, stream in streams.items():
+            rewritten, i = [], 0
+            while i < len(stream):
+                if tuple(entry[0] for entry in stream[i:i + len(best_key)]) == best_key:
+                    segment = segment or stream[i:i + len(best_key)]
+                    rewritten.append(('call', index, len(best_key)))
+                    i += len(best_key)
+                else:
+                    rewritten.append(stream[i])
+                    i += 1
+            streams[song_name] = rewritten
+        segments.append(segment)
+
+    assert all(entry[0] != 'call' for segment in segments for entry in segment), "nested segment call"
+    return segments
+
+
+def stream_size(stream: List) -> int:
+    """Flash bytes of a (possibly segment-referencing) note stream"""
+    return sum(2 if entry[0] == 'call' else len(entry[0]) for entry in stream)
+
+
+def format_note_entry(entry, tick_ms: Optional[int]) -> str:
+    """One packed note (or segment call) per line with a readable comment"""
+    if entry[0] == 'call':
+        return f"    {f'0x{CODE_SEGMENT_CALL:02X}, {entry[1]},':<10} // segment {entry[1]} ({entry[2]} notes)"
+    code, pitch, note_ticks = entry
+    values = ', '.join(f"0x{byte:02X}" if i == 0 else str(byte) for i, byte in enumerate(code))
+    if tick_ms:
+        duration = f"{note_ticks * tick_ms} ms"
+    elif code[0] >> 6 == DURATION_CODE_EXPLICIT:
+        duration = f"{note_ticks} ticks"
+    else:
+        duration = f"duration code {code[0] >> 6}"  # Resolved by the calling song
+    return f"    {values + ',':<10} // {pitch_name(pitch):<4} {duration}"
+
+
+def midi_frequency(midi: int) -> float:
+    """Equal-tempered concert pitch of a MIDI note"""
+    return 440.0 * 2 ** ((midi - 69) / 12.0)
+
+
+def timer1_tone(hz: float, f_cpu: int) -> Tuple[int, int]:
+    """Timer1 clock select and top for a tone: the smallest prescaler whose period fits 8 bits"""
+    for clock_select in range(1, TIMER1_CLOCK_SELECTS + 1):
+        period = int(round(f_cpu / (1 << (clock_select - 1)) / hz))
+        if period <= 256:
+            return clock_select, max(2, period) - 1
+    raise ValueError(f"{hz:.2f} Hz is below the Timer1 range at F_CPU = {f_cpu}")
+
+
+def cents(played_hz: float, hz: float) -> float:
+    return 1200 * math.log2(played_hz / hz)
+
+
+def generate_pitch_tables(f_cpu: int) -> Tuple[str, float, float]:
+    """Generate the per-pitch Timer1 and DDS tables, with their worst tuning error in cents"""
+    timer_lines, step_lines = [], []
+    timer_error = step_error = 0.0
+    sample_rate = f_cpu / DDS_SAMPLE_DIVIDER
+    for pitch in range(PITCH_COUNT):
+        hz = midi_frequency(PITCH_BASE_MIDI + pitch)
+        clock_select, top = timer1_tone(hz, f_cpu)
+        played_hz = f_cpu / (1 << (clock_select - 1)) / (top + 1)
+        timer_error = max(timer_error, abs(cents(played_hz, hz)))
+        timer_lines.append(f"    {f'{{{clock_select}, {top}}},':<10} // {pitch:<2} {PITCH_NAMES[pitch]:<4} "
+                           f"{hz:7.2f} Hz -> {played_hz:7.2f} Hz ({cents(played_hz, hz):+.1f} cents)")
+        step = int(round(hz * 65536 / sample_rate))
+        step_error = max(step_error, abs(cents(step * sample_rate / 65536, hz)))
+        step_lines.append(f"    {f'{step},':<6} // {pitch:<2} {PITCH_NAMES[pitch]}")
+
+    lines = [
+        f"// Pitch tables: equal temperament (A4 = 440 Hz) at F_CPU = {f_cpu}, indexed by packed pitch index",
+        f"#if F_CPU != {f_cpu}",
+        '#error "Pitch tables were generated for another F_CPU - rerun scripts/generate_audio_code.py --f-cpu"',
+        "#endif",
+        "",
+        f"// Square tone: f = F_CPU / (2^(clock_select - 1) * (top + 1)), worst error {timer_error:.1f} cents",
+        "const audio_pitch_timer_t PROGMEM audio_pitch_timers[AUDIO_PITCH_COUNT] = {",
+    ]
+    lines.extend(timer_lines)
+    lines.append("};")
+    lines.append("")
+    lines.append("#if FEATURE_AUDIO_DDS")
+    lines.append(f"// DDS phase steps: step = f * 65536 / (F_CPU / {DDS_SAMPLE_DIVIDER}), worst error {step_error:.1f} cents")
+    lines.append("const uint16_t PROGMEM audio_pitch_dds_steps[AUDIO_PITCH_COUNT] = {")
+    lines.extend(step_lines)
+    lines.append("};")
+    lines.append("#endif")
+    lines.append("")
+    return '\n'.join(lines), timer_error, step_error
+
+
+def generate_segment_data(segments: List[List]) -> str:
+    """Generate the shared segment pool and its offset table"""
+    lines = [
+        f"// Shared segments: {len(segments)} repeated phrases, played via AUDIO_PITCH_SEGMENT",
+        "// Durations are decoded with the tick table of the calling song",
+        "const uint8_t PROGMEM audio_segment_notes[] = {",
+    ]
+    offsets, offset = [], 0
+    for index, segment in enumerate(segments):
+        offsets.append(offset)
+        lines.append(f"    // Segment {index}")
+        lines.extend(format_note_entry(entry, None) for entry in segment)
+        lines.append(f"    {f'0x{CODE_SEGMENT_RETURN:02X},':<10} // end of segment {index}")
+        offset += stream_size(segment) + 1
+    if not segments:
+        lines.append(f"    0x{CODE_SEGMENT_RETURN:02X}, // no shared segments")
+        offsets.append(0)
+    lines.append("};")
+    lines.append("")
+    lines.append("const uint16_t PROGMEM audio_segment_offsets[] = {")
+    lines.append("    " + ', '.join(str(o) for o in offsets) + ",")
+    lines.append("};")
+    lines.append("")
+    return '\n'.join(lines)
+
+
+def generate_song_data(song_name: str, note_count: int, packed: Dict, stream: List, var_name: Optional[str] = None,
+                       harmony_stream: Optional[List] = None) -> str:
+    """Generate packed PROGMEM note stream and descriptor for a single song (harmony_stream = shared harmony)"""
     identifier = sanitize_identifier(song_name)
-    
+    var_name = var_name or f"melody_{identifier.lower()}"
+    tick_ms = packed['tick_ms']
+
     lines = [
-        f"// Song: {song_name} ({len(notes)} notes)",
-        f"static const audio_note_t PROGMEM melody_{identifier.lower()}[] = {{",
+        f"// Song: {song_name} ({note_count} notes, {stream_size(stream)} bytes packed, {tick_ms} ms tick)",
+        f"static const uint8_t PROGMEM {var_name}_notes[] = {{",
     ]
     
-    for freq, duration in notes:
-        lines.append(f"    {{{freq}, {duration}}},")
+    lines.extend(format_note_entry(entry, tick_ms) for entry in stream)
     
     lines.append("};")
+
+    # Second voice for the DDS engine - compiled out with the square-wave tone
+    harmony = "NULL, 0"
+    if packed['harmony']:
+        harmony_stream = harmony_stream or packed['harmony']
+        lines.append("#if FEATURE_AUDIO_DDS")
+        lines.append(f"// Harmony: {len(packed['harmony'])} notes, {stream_size(harmony_stream)} bytes packed")
+        lines.append(f"static const uint8_t PROGMEM {var_name}_harmony[] = {{")
+        lines.extend(format_note_entry(entry, tick_ms) for entry in harmony_stream)
+        lines.append("};")
+        lines.append("#endif")
+        harmony = f"{var_name}_harmony, {len(packed['harmony'])}"
+
+    d0, d1, d2 = packed['duration_ticks']
+    lines.append(f"static const audio_song_t PROGMEM {var_name} = {{{var_name}_notes, {tick_ms}, {note_count}, "
+                 f"{{{d0}, {d1}, {d2}}}, {packed['gap_ms']}, {packed['duty_scale']}, {packed['transpose']}"
+                 f" AUDIO_SONG_HARMONY({harmony})}};")
     lines.append("")
     
     return '\n'.join(lines)
@@ -209,13 +637,6 @@ def generate_song_data(song_name: str, notes: List[Tuple[int, int]]) -> str:
 
 def generate_config_array(config: Dict, all_songs: Dict) -> str:
     """Generate song_configs array with defaults for missing configurations"""
-    yaml_songs = config.get('songs', {})
-    
-    # Default values
-    DEFAULT_DUTY_CYCLE = 75
-    DEFAULT_SPEED = 100
-    DEFAULT_TRANSPOSE = 0
-    
     lines = [
         "static const song_config_t song_configs[] = {",
         "    [MELODY_NONE] = {50, 100, 0},  // Default fallback",
@@ -225,10 +646,10 @@ def generate_config_array(config: Dict, all_songs: Dict) -> str:
         identifier = sanitize_identifier(song_name)
         
         # Get configuration from YAML or use defaults
-        song_config = yaml_songs.get(song_name, {})
-        duty = song_config.get('duty_cycle', DEFAULT_DUTY_CYCLE)
-        speed = song_config.get('speed', DEFAULT_SPEED)
-        transpose = song_config.get('transpose', DEFAULT_TRANSPOSE)
+        song_config = resolve_song_config(config, song_name)
+        duty = song_config['duty_cycle']
+        speed = song_config['speed']
+        transpose = song_config['transpose']
         
         lines.append(f"    [MELODY_{identifier}] = {{{duty}, {speed}, {transpose}}},  // {song_name}")
     
@@ -238,20 +659,8 @@ def generate_config_array(config: Dict, all_songs: Dict) -> str:
     return '\n'.join(lines)
 
 
-def generate_enabled_songs(config: Dict, all_songs: Dict) -> str:
-    """Generate enabled_songs array - enable all songs by default unless explicitly disabled"""
-    yaml_songs = config.get('songs', {})
-    
-    # Default: enable songs unless explicitly set to false in YAML
-    enabled_list = []
-    for song_name in all_songs.keys():
-        song_config = yaml_songs.get(song_name, {})
-        # If song is not in YAML, default to enabled=true
-        # If song is in YAML, use the 'enabled' value (default to true if not specified)
-        is_enabled = song_config.get('enabled', True)
-        if is_enabled:
-            enabled_list.append(song_name)
-    
+def generate_enabled_songs(enabled_list: List[str]) -> str:
+    """Generate enabled_songs array - the songs that made it into flash, in rotation order"""
     enabled_count = len(enabled_list)
     
     lines = [
@@ -273,7 +682,7 @@ def generate_enabled_songs(config: Dict, all_songs: Dict) -> str:
 def generate_get_melody_data(songs: Dict) -> str:
     """Generate get_melody_data() function"""
     lines = [
-        "const audio_note_t *get_melody_data(melody_id_t melody_id, uint8_t *note_count)",
+        "const audio_song_t *get_melody_data(melody_id_t melody_id)",
         "{",
         "    switch (melody_id) {",
     ]
@@ -282,17 +691,14 @@ def generate_get_melody_data(songs: Dict) -> str:
         identifier = sanitize_identifier(song_name)
         var_name = identifier.lower()
         lines.append(f"    case MELODY_{identifier}:")
-        lines.append(f"        *note_count = sizeof(melody_{var_name}) / sizeof(audio_note_t);")
-        lines.append(f"        return melody_{var_name};")
+        lines.append(f"        return &melody_{var_name};")
         lines.append("")
     
     lines.append("    case MELODY_TEST_TONE:")
-    lines.append("        *note_count = sizeof(melody_test_tone) / sizeof(audio_note_t);")
-    lines.append("        return melody_test_tone;")
+    lines.append("        return &melody_test_tone;")
     lines.append("")
     lines.append("    case MELODY_NONE:")
     lines.append("    default:")
-    lines.append("        *note_count = 0;")
     lines.append("        return NULL;")
     lines.append("    }")
     lines.append("}")
@@ -300,6 +706,31 @@ def generate_get_melody_data(songs: Dict) -> str:
     return '\n'.join(lines)
 
 
+# Effects of the flash registry in lighting.cpp: config.yaml name -> feature flag, lighting_effect_t
+LIGHTING_EFFECTS = {
+    'candle': ('FEATURE_CANDLE_EFFECT', 'LIGHTING_EFFECT_CANDLE'),
+    'breathing': ('FEATURE_BREATHING_EFFECT', 'LIGHTING_EFFECT_BREATHING'),
+    'adc_test': ('FEATURE_ADC_TEST_EFFECT', 'LIGHTING_EFFECT_ADC_TEST'),
+}
+
+
+def generate_lighting_effects(config: Dict) -> List[str]:
+    """Feature flags of the effects listed in config.yaml, the first one is shown at boot"""
+    effects = config.get('lighting', {}).get('effects', ['candle'])
+    if not effects:
+        raise ValueError("lighting.effects in config.yaml needs at least one effect")
+    for name in effects:
+        if name not in LIGHTING_EFFECTS:
+            raise ValueError(f"Unknown lighting effect '{name}' (known: {', '.join(LIGHTING_EFFECTS)})")
+
+    defines = ['// Lighting Effects (a long blow cycles through the enabled ones)']
+    for name, (flag, _) in LIGHTING_EFFECTS.items():
+        defines.append(f'#define {flag} {1 if name in effects else 0}')
+    defines.append(f'#define LIGHTING_EFFECT_DEFAULT {LIGHTING_EFFECTS[effects[0]][1]}')
+    defines.append('')
+    return defines
+
+
 def generate_hardware_config(config: Dict) -> str:
     """Generate hardware configuration header content from YAML"""
     hardware = config.get('hardware', {})
@@ -322,6 +753,9 @@ def generate_hardware_config(config: Dict) -> str:
         # Sensor settings
         'breath_sensitivity': ('BREATH_SENSITIVITY', 1),
         'sensor_update_rate': ('SENSOR_UPDATE_RATE_MS', 5),
+        
+        # Power management
+        'standby_timeout': ('STANDBY_TIMEOUT_S', 1800),
     }
     
     # Get values from YAML or use defaults
@@ -331,7 +765,8 @@ def generate_hardware_config(config: Dict) -> str:
     categories = {
         'Sensor Configuration': ['breath_sensitivity', 'sensor_update_rate'],
         'LED Configuration': ['led_brightness_default', 'candle_flicker_speed', 'candle_flicker_intensity'],
-        'Audio Configuration': ['audio_max_frequency', 'audio_min_frequency', 'audio_default_volume', 'song_cooldown', 'note_separation', 'startup_melody']
+        'Audio Configuration': ['audio_max_frequency', 'audio_min_frequency', 'audio_default_volume', 'song_cooldown', 'note_separation', 'startup_melody'],
+        'Power Management': ['standby_timeout']
     }
     
     for category, params in categories.items():
@@ -350,6 +785,8 @@ def generate_hardware_config(config: Dict) -> str:
                 defines.append(f'#define {c_define} {c_value}')
         defines.append('')
     
+    defines.extend(generate_lighting_effects(config))
+
     # Remove the last empty line
     if defines and defines[-1] == '':
         defines.pop()
@@ -382,6 +819,13 @@ def generate_hardware_config(config: Dict) -> str:
 
 def main():
     """Main code generation function"""
+    arg_parser = argparse.ArgumentParser(description='MusicXML to C code generator for BlinkyTree')
+    arg_parser.add_argument('--elf', type=Path, help='firmware.elf of the last build, measures code size for the flash budget')
+    arg_parser.add_argument('--f-cpu', type=int, default=DEFAULT_F_CPU, help='CPU clock the pitch tables are computed for')
+    arg_parser.add_argument('--dds', action='store_true', help='budget for a FEATURE_AUDIO_DDS build (harmony data and fields linked)')
+    arg_parser.add_argument('--fixtures', type=Path, help='extra MusicXML test songs (bench builds): in flash, not in the rotation or budget')
+    args = arg_parser.parse_args()
+
     script_dir = Path(__file__).parent
     project_root = script_dir.parent
     config_file = project_root / 'config.yaml'
@@ -402,18 +846,25 @@ def main():
         return 1
     
     print(f"Found {len(musicxml_files)} MusicXML file(s)")
+    fixture_files = sorted(args.fixtures.glob('*.musicxml')) if args.fixtures else []
+    fixtures = [musicxml_file.stem for musicxml_file in fixture_files]
+    if fixtures:
+        print(f"Found {len(fixtures)} fixture(s) in {args.fixtures}")
     
-    # Parse all MusicXML files
+    # Parse all MusicXML files, fixtures last
     song_data = {}
-    for musicxml_file in sorted(musicxml_files):
+    harmony_data = {}
+    for musicxml_file in sorted(musicxml_files) + fixture_files:
         # Extract song name from filename (without .musicxml extension)
         song_name = musicxml_file.stem
         
         print(f"Parsing {song_name}...")
         parser = MusicXMLParser(musicxml_file)
-        notes = parser.parse()
+        notes, harmony = parser.parse_voices()
         song_data[song_name] = notes
-        print(f"  -> {len(notes)} notes extracted")
+        if harmony:
+            harmony_data[song_name] = harmony
+        print(f"  -> {len(notes)} notes extracted" + (f", {len(harmony)} harmony notes" if harmony else ""))
     
     # Generate hardware configuration file
     print(f"\nGenerating hardware configuration...")
@@ -440,8 +891,9 @@ def main():
 #define AUDIO_SONGS_GENERATED_H_
 
 #include <stdint.h>
+#include <avr/pgmspace.h>
 
-// Note: This file is included from audio.h AFTER audio_note_t and song_config_t are defined
+// Note: This file is included from audio.h AFTER audio_song_t and song_config_t are defined
 // Do not include audio.h here to avoid circular dependency
 
 // ============================================================================
@@ -454,9 +906,19 @@ def main():
 // FUNCTION DECLARATIONS
 // ============================================================================
 
-const audio_note_t *get_melody_data(melody_id_t melody_id, uint8_t *note_count);
+const audio_song_t *get_melody_data(melody_id_t melody_id); // PROGMEM descriptor (NULL for none)
 const song_config_t *get_song_config(melody_id_t melody_id);
 
+// Timer1 setting and DDS phase step per pitch index (PROGMEM)
+extern const audio_pitch_timer_t audio_pitch_timers[] PROGMEM;
+#if FEATURE_AUDIO_DDS
+extern const uint16_t audio_pitch_dds_steps[] PROGMEM;
+#endif
+
+// Shared phrase segments referenced by AUDIO_PITCH_SEGMENT codes (PROGMEM)
+extern const uint8_t audio_segment_notes[] PROGMEM;
+extern const uint16_t audio_segment_offsets[] PROGMEM;
+
 // ============================================================================
 // ENABLED SONGS DECLARATIONS
 // ============================================================================
@@ -476,17 +938,60 @@ extern const uint8_t ENABLED_SONG_COUNT;
     # Generate implementation file
     print("Generating audio_songs_generated.cpp...")
     
-    # Generate all song data
-    all_song_data = []
-    for song_name, notes in song_data.items():
-        all_song_data.append(generate_song_data(song_name, notes))
-    
-    # Add test tone
-    all_song_data.append('''// Test tone: 5-second A4 note
-static const audio_note_t PROGMEM melody_test_tone[] = {
-    {440, 5000},  // A4 for 5 seconds
-};
-''')
+    # Pack all songs (with their config.yaml playback settings)
+    note_gap_ms = config.get('hardware', {}).get('note_separation', DEFAULT_NOTE_GAP_MS)
+    packed_songs = {song_name: encode_song(notes, song_name, resolve_song_config(config, song_name), note_gap_ms,
+                                           harmony_data.get(song_name))
+                    for song_name, notes in song_data.items()}
+
+    # Test tone: 5-second A4 note, always in flash
+    test_tone_config = {'duty_cycle': 80, 'speed': 100, 'transpose': 0}
+    test_tone = encode_song([(PITCH_NAMES.index('A4'), 5000)], 'Test tone', test_tone_config, note_gap_ms)
+
+    # Keep enabled songs by priority while they fit the flash budget, then share repeated phrases between them
+    budget, budget_source = resolve_song_budget(config, args.elf)
+    songs_only = {song_name: packed for song_name, packed in packed_songs.items() if song_name not in fixtures}
+    enabled_list, dropped = fit_songs(config, songs_only, test_tone, budget, args.dds)
+    if not enabled_list:
+        print(f"Error: no enabled song fits the {budget} byte song budget ({budget_source})", file=sys.stderr)
+        return 1
+    streams, harmonies, segments, total_shared = pack_song_set(packed_songs, enabled_list + fixtures, test_tone, args.dds)
+
+    # Generate song data for the songs in flash (file order, rotation order is in enabled_songs[])
+    pitch_tables, timer_error, step_error = generate_pitch_tables(args.f_cpu)
+    all_song_data = [generate_segment_data(segments)]
+    in_flash = {song_name: notes for song_name, notes in song_data.items() if song_name in streams}
+    for song_name, notes in in_flash.items():
+        all_song_data.append(generate_song_data(song_name, len(notes), packed_songs[song_name], streams[song_name],
+                                                harmony_stream=harmonies.get(song_name)))
+    all_song_data.append(generate_song_data('Test tone', 1, test_tone, test_tone['encoded'], 'melody_test_tone'))
+
+    # Flash usage report: packed + shared segments vs. the former 4-byte audio_note_t
+    descriptor = descriptor_size(args.dds)
+    print(f"\nPacked song data (PROGMEM bytes incl. descriptor, rotation order, {'DDS' if args.dds else 'tone'} build):")
+    for song_name in enabled_list:
+        notes = song_data[song_name]
+        harmony_size = stream_size(harmonies[song_name]) if song_name in harmonies else 0
+        print(f"  {song_name}: {stream_size(streams[song_name]) + descriptor} bytes (was {len(notes) * 4}, "
+              f"alone {packed_songs[song_name]['size'] + descriptor})"
+              + (f" + {harmony_size} bytes harmony" if harmony_size else ""))
+    for song_name in dropped:
+        print(f"  {song_name}: DROPPED - {packed_songs[song_name]['size'] + descriptor} bytes do not fit "
+              f"(priority {resolve_song_priority(config, song_name)})")
+    segment_size = sum(stream_size(segment) + SEGMENT_OVERHEAD for segment in segments)
+    total_packed = sum(packed_songs[song_name]['size'] + descriptor for song_name in enabled_list + fixtures)
+    print(f"  Shared segments: {len(segments)} ({segment_size} bytes)")
+    print(f"  Test tone: {test_tone['size'] + descriptor} bytes")
+    for song_name in fixtures:
+        print(f"  Fixture {song_name}: {stream_size(streams[song_name]) + descriptor} bytes"
+              + (f" + {stream_size(harmonies[song_name])} bytes harmony" if song_name in harmonies else ""))
+    print(f"  Total: {total_shared} bytes (packed without sharing: {total_packed + test_tone['size'] + descriptor}, "
+          f"unpacked: {sum(len(song_data[song_name]) * 4 for song_name in enabled_list + fixtures)})")
+    print(f"  Pitch tables: F_CPU {args.f_cpu}, worst error {timer_error:.1f} cents (Timer1), {step_error:.1f} cents (DDS)")
+    if budget is None:
+        print(f"  Flash budget: {budget_source}")
+    else:
+        print(f"  Flash budget: {budget} bytes ({budget_source}), headroom {budget - total_shared} bytes")
     
     cpp_content = f'''/*
  * audio_songs_generated.cpp - Auto-generated song data
@@ -504,6 +1009,11 @@ static const audio_note_t PROGMEM melody_test_tone[] = {
 #include "../../config/config.h"
 #include <avr/pgmspace.h>
 
+// ============================================================================
+// PITCH TABLES - Timer1 and DDS settings per pitch index, no runtime division
+// ============================================================================
+
+{pitch_tables}
 // ============================================================================
 // MELODY DATA - Generated from MusicXML files
 // All melody data stored in PROGMEM to save RAM
@@ -518,16 +1028,16 @@ static const audio_note_t PROGMEM melody_test_tone[] = {
 {generate_config_array(config, song_data)}
 
 // ============================================================================
-// ENABLED SONGS LIST - From config.yaml (enabled by default)
+// ENABLED SONGS LIST - From config.yaml (enabled by default, by priority while flash lasts)
 // ============================================================================
 
-{generate_enabled_songs(config, song_data)}
+{generate_enabled_songs(enabled_list)}
 
 // ============================================================================
 // ACCESSOR FUNCTIONS
 // ============================================================================
 
-{generate_get_melody_data(song_data)}
+{generate_get_melody_data(in_flash)}
 
 const song_config_t *get_song_config(melody_id_t melody_id)
 {{
@@ -13,6 +13,27 @@ from pathlib import Path
 project_dir = Path(env["PROJECT_DIR"])
 script_path = project_dir / "scripts" / "generate_audio_code.py"
 
+# The previous link of this env measures the code size for the song flash budget
+elf_path = Path(env.subst("$BUILD_DIR")) / (env.subst("$PROGNAME") + ".elf")
+
+# Pitch tables are computed for the env's clock (board_build.f_cpu, native has none)
+f_cpu = str(env.get("BOARD_F_CPU", "8000000L")).rstrip("UuLl")
+
+# The flash budget counts the harmony streams and descriptor fields only when the DDS engine is linked
+def defined_true(name):
+    for define in env.get("CPPDEFINES", []):
+        if isinstance(define, (list, tuple)):
+            if define[0] == name:
+                return str(define[1]) not in ("0", "")
+        elif define == name:
+            return True
+    return False
+
+dds_args = ["--dds"] if defined_true("FEATURE_AUDIO_DDS") else []
+
+# Host bench builds also link the test songs of bench/fixtures (never flashed)
+fixture_args = ["--fixtures", str(project_dir / "bench" / "fixtures")] if defined_true("PLATFORM_NATIVE") else []
+
 print("=" * 60)
 print("PRE-BUILD: Generating audio code from MusicXML files...")
 print("=" * 60)
@@ -20,7 +41,7 @@ print("=" * 60)
 try:
     # Run the code generation script
     result = subprocess.run(
-        [sys.executable, str(script_path)],
+        [sys.executable, str(script_path), "--elf", str(elf_path), "--f-cpu", f_cpu] + dds_args + fixture_args,
         cwd=str(project_dir),
         capture_output=True,
         text=True,
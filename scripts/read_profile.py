@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""
+Profile table reader for BlinkyTree (FEATURE_PROFILING builds)
+Decodes the PROF_BEGIN/PROF_END counters dumped to EEPROM
+
+Read the EEPROM over ISP first, e.g.:
+    avrdude -c avrispv2 -p attiny85 -P /dev/ttyACM0 -U eeprom:r:profile.hex:i
+then:
+    python3 scripts/read_profile.py profile.hex [task names...]
+
+Task names default to the main_tasks[] order in src/main.cpp.
+
+Copyright (c) 2025 monkeyToneCircuits
+Licensed under CC-BY-NC 4.0
+"""
+
+import struct
+import sys
+
+F_CPU = 8000000
+EEPROM_ADDR_PROFILE = 0x40
+PROF_EEPROM_MAGIC = 0x50
+SCHEDULER_MAX_TASKS = 8
+DEFAULT_TASK_NAMES = ['audio_update', 'lighting_update', 'lighting_interpolate', 'sensors_update',
+                      'standby_update', 'profiler_dump']
+FIXED_PROBE_NAMES = ['hardware_microphone_read', 'PWM ISR', 'DDS ISR']
+
+
+def read_eeprom(path):
+    """Raw binary (avrdude :r) or Intel hex (avrdude :i) EEPROM image"""
+    with open(path, 'rb') as f:
+        data = f.read()
+    if not data.startswith(b':'):
+        return data
+
+    image = bytearray(512)
+    for line in data.decode('ascii').split():
+        record = bytes.fromhex(line[1:])
+        length, address, kind = record[0], (record[1] << 8) | record[2], record[3]
+        if kind == 0:
+            image[address:address + length] = record[4:4 + length]
+    return bytes(image)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__.strip())
+        return 1
+
+    image = read_eeprom(sys.argv[1])
+    task_names = sys.argv[2:] or DEFAULT_TASK_NAMES
+
+    magic, count, stamp_cycles, entry_size = image[EEPROM_ADDR_PROFILE:EEPROM_ADDR_PROFILE + 4]
+    if magic != PROF_EEPROM_MAGIC or entry_size != 10:
+        print("No profile dump at 0x%02X (magic 0x%02X) - flash an attiny85_profile build and let it run"
+              % (EEPROM_ADDR_PROFILE, magic))
+        return 1
+
+    names = ['task %d %s' % (i, task_names[i] if i < len(task_names) else '') for i in range(SCHEDULER_MAX_TASKS)]
+    names += FIXED_PROBE_NAMES
+
+    print("%-36s %8s %10s %10s %10s %10s" % ('probe', 'calls', 'min cyc', 'avg cyc', 'max cyc', 'avg us'))
+    offset = EEPROM_ADDR_PROFILE + 4
+    for probe in range(count):
+        calls, low, high, total = struct.unpack_from('<HHHI', image, offset)
+        offset += entry_size
+        if calls == 0:
+            continue
+        average = total * stamp_cycles / calls
+        name = names[probe] if probe < len(names) else 'probe %d' % probe
+        print("%-36s %8d %10d %10.0f %10d %10.1f" % (name.strip(), calls, low * stamp_cycles, average,
+                                                     high * stamp_cycles, average * 1e6 / F_CPU))
+
+    print("\nResolution: %d CPU cycles per stamp (%.1f us)" % (stamp_cycles, stamp_cycles * 1e6 / F_CPU))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+"""
+Telemetry decoder for BlinkyTree (FEATURE_TELEMETRY builds)
+Decodes the soft-UART frames sent on PB2 (ISP SCK) and plots the breath detector
+
+Flash the attiny85_telemetry env and wire a 3.3V/5V USB-serial RX to PB2 (ISP pin 7) and GND:
+    pio run -e attiny85_telemetry --target upload
+then record from the port (needs pyserial) or decode a raw capture:
+    python3 scripts/read_telemetry.py --port /dev/ttyUSB0 --seconds 30 -r capture.bin --plot
+    python3 scripts/read_telemetry.py capture.bin [--csv frames.csv] [--adc-trace breath.txt] [--plot]
+
+Outputs:
+    summary     - frames, dropped frames (sequence gaps), checksum errors, events, loop load
+    --csv       - one row per frame: detector state, events and scheduler load
+    --adc-trace - raw ADC samples, one per line at 1kHz: the input format of the host bench
+                  (pio run -e native, program breath.txt), to tune the detector against real blows
+    --plot      - samples, baseline and baseline + envelope with the trigger events (needs matplotlib)
+
+Copyright (c) 2025 monkeyToneCircuits
+Licensed under CC-BY-NC 4.0
+"""
+
+import argparse
+import csv
+import sys
+
+F_CPU = 8000000
+BAUD = 25000                # HARDWARE_TELEMETRY_BAUD (31250 with FEATURE_LED_HW_PWM)
+TELEMETRY_SYNC = 0xA5
+TELEMETRY_FRAME_MS = 20
+TELEMETRY_MAX_SAMPLES = 24
+TELEMETRY_HEADER_SIZE = 13
+TELEMETRY_CYCLE_UNIT = 64   # CPU cycles per loop time unit
+EVENTS = {0x01: 'song_start', 0x02: 'song_stop', 0x04: 'effect_switch', 0x08: 'samples_lost'}
+
+
+def unpack_samples(data, count):
+    """10-bit samples packed LSB first"""
+    bits = int.from_bytes(data, 'little')
+    return [(bits >> (10 * i)) & 0x3FF for i in range(count)]
+
+
+def decode(stream):
+    """Frames as dicts, resynchronising on the sync byte after a damaged one"""
+    frames, errors = [], 0
+    pos = 0
+    while pos + TELEMETRY_HEADER_SIZE + 1 <= len(stream):
+        if stream[pos] != TELEMETRY_SYNC:
+            pos += 1
+            continue
+        count = stream[pos + 2]
+        length = TELEMETRY_HEADER_SIZE + (count * 10 + 7) // 8
+        if count > TELEMETRY_MAX_SAMPLES or pos + length + 1 > len(stream):
+            pos += 1
+            continue
+        if sum(stream[pos + 1:pos + length]) & 0xFF != stream[pos + length]:
+            errors += 1
+            pos += 1
+            continue
+
+        header = stream[pos:pos + TELEMETRY_HEADER_SIZE]
+        frames.append({
+            'sequence': header[1],
+            'events': header[3],
+            'baseline': header[4] | (header[5] << 8),
+            'envelope': header[6] | (header[7] << 8),
+            'passes': header[8],
+            'pass_max_us': (header[9] | (header[10] << 8)) * TELEMETRY_CYCLE_UNIT * 1e6 / F_CPU,
+            'busy_us': (header[11] | (header[12] << 8)) * TELEMETRY_CYCLE_UNIT * 1e6 / F_CPU,
+            'samples': unpack_samples(stream[pos + TELEMETRY_HEADER_SIZE:pos + length], count),
+        })
+        pos += length + 1
+    return frames, errors
+
+
+def number_frames(frames):
+    """Frame index from the wrapping 8-bit sequence - gaps are frames the TX queue dropped"""
+    dropped = 0
+    index = 0
+    for i, frame in enumerate(frames):
+        if i:
+            gap = (frame['sequence'] - frames[i - 1]['sequence']) & 0xFF
+            dropped += max(0, gap - 1)
+            index += max(1, gap)
+        frame['index'] = index
+        frame['ms'] = index * TELEMETRY_FRAME_MS
+    return dropped
+
+
+def record(port, seconds, baud):
+    import serial  # pyserial - only needed to record
+
+    with serial.Serial(port, baud, timeout=0.5) as line:
+        line.reset_input_buffer()
+        data = bytearray()
+        chunks = int(seconds / 0.5) if seconds else None
+        try:
+            while chunks is None or chunks > 0:
+                data += line.read(max(1, baud // 20))
+                if chunks is not None:
+                    chunks -= 1
+        except KeyboardInterrupt:
+            pass
+    return bytes(data)
+
+
+def write_csv(path, frames):
+    with open(path, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['ms', 'sequence', 'samples', 'baseline', 'envelope', 'events',
+                         'passes', 'pass_max_us', 'busy_percent'])
+        for frame in frames:
+            names = '|'.join(name for bit, name in EVENTS.items() if frame['events'] & bit)
+            writer.writerow([frame['ms'], frame['sequence'], len(frame['samples']), frame['baseline'],
+                             frame['envelope'], names, frame['passes'], '%.0f' % frame['pass_max_us'],
+                             '%.1f' % (frame['busy_us'] * 100 / (TELEMETRY_FRAME_MS * 1000))])
+
+
+def write_adc_trace(path, frames):
+    with open(path, 'w') as f:
+        f.write('# BlinkyTree telemetry capture - one ADC reading per line at 1kHz\n')
+        last = None
+        for frame in frames:
+            if last is not None and frame['index'] != last + 1:
+                f.write('# %d frame(s) dropped\n' % (frame['index'] - last - 1))
+            last = frame['index']
+            for sample in frame['samples']:
+                f.write('%d\n' % sample)
+
+
+def plot(frames):
+    import matplotlib.pyplot as plt
+
+    fig, (adc, load) = plt.subplots(2, 1, sharex=True, figsize=(12, 7), gridspec_kw={'height_ratios': [3, 1]})
+    for frame in frames:
+        count = len(frame['samples'])
+        times = [frame['ms'] + i * TELEMETRY_FRAME_MS / max(count, 1) for i in range(count)]
+        adc.plot(times, frame['samples'], '.', color='tab:blue', markersize=2)
+    ms = [frame['ms'] for frame in frames]
+    adc.step(ms, [f['baseline'] for f in frames], where='post', color='tab:green', label='baseline')
+    adc.step(ms, [f['baseline'] + f['envelope'] for f in frames], where='post', color='tab:orange',
+             label='baseline + envelope')
+    for bit, name in EVENTS.items():
+        hits = [f['ms'] for f in frames if f['events'] & bit]
+        if hits:
+            adc.vlines(hits, 0, 1, transform=adc.get_xaxis_transform(), linestyles='dashed',
+                       colors='C%d' % (3 + bit.bit_length()), label=name)
+    adc.set_ylabel('ADC counts')
+    adc.legend(loc='upper right')
+
+    load.plot(ms, [f['busy_us'] * 100 / (TELEMETRY_FRAME_MS * 1000) for f in frames], label='busy %')
+    load.plot(ms, [f['pass_max_us'] / 10 for f in frames], label='longest pass (10 us)')
+    load.set_xlabel('ms')
+    load.legend(loc='upper right')
+    plt.tight_layout()
+    plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('capture', nargs='?', help='raw capture file (instead of --port)')
+    parser.add_argument('--port', help='serial port to record from')
+    parser.add_argument('--baud', type=int, default=BAUD)
+    parser.add_argument('--seconds', type=float, default=0, help='recording length (0 = until Ctrl+C)')
+    parser.add_argument('-r', '--raw', help='save the recorded bytes here')
+    parser.add_argument('--csv', help='write the per-frame CSV here')
+    parser.add_argument('--adc-trace', help='write the raw samples in the bench trace format here')
+    parser.add_argument('--plot', action='store_true')
+    args = parser.parse_args()
+
+    if args.port:
+        stream = record(args.port, args.seconds, args.baud)
+        if args.raw:
+            with open(args.raw, 'wb') as f:
+                f.write(stream)
+    elif args.capture:
+        with open(args.capture, 'rb') as f:
+            stream = f.read()
+    else:
+        parser.print_usage()
+        return 1
+
+    frames, errors = decode(stream)
+    if not frames:
+        print("No telemetry frames in %d bytes - check the wiring (PB2, GND) and the baud rate" % len(stream))
+        return 1
+    dropped = number_frames(frames)
+
+    samples = sum(len(f['samples']) for f in frames)
+    busy = [f['busy_us'] * 100 / (TELEMETRY_FRAME_MS * 1000) for f in frames]
+    print("%d frames (%.1f s), %d dropped, %d checksum errors, %d samples" %
+          (len(frames), (frames[-1]['ms'] + TELEMETRY_FRAME_MS) / 1000, dropped, errors, samples))
+    for bit, name in EVENTS.items():
+        print("  %-14s %d" % (name, sum(1 for f in frames if f['events'] & bit)))
+    print("Loop: %.1f%% busy on average, %.1f%% worst frame, longest pass %.0f us" %
+          (sum(busy) / len(busy), max(busy), max(f['pass_max_us'] for f in frames)))
+
+    if args.csv:
+        write_csv(args.csv, frames)
+    if args.adc_trace:
+        write_adc_trace(args.adc_trace, frames)
+    if args.plot:
+        plot(frames)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
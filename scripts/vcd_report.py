@@ -0,0 +1,311 @@
+#!/usr/bin/env python3
+"""
+Simulation report for BlinkyTree (attiny85_sim builds)
+Turns the simavr VCD trace into timing and pitch numbers as JSON
+
+Run the simulation first (see the simulate job in .github/workflows/build.yml):
+    pio run -e attiny85_sim
+    simavr -m attiny85 -f 8000000 .pio/build/attiny85_sim/firmware.elf
+then:
+    python3 scripts/vcd_report.py blinkytree_sim.vcd [-o report.json] [limits...]
+
+Reported:
+    pwm     - frame rate and frame-to-frame jitter per LED pin (rising edge to rising edge)
+    songs   - every tone started while a melody plays, error in cents against the notated
+              pitch (NOTE_* name in lib/Audio/audio.h) and against the nearest semitone
+    loop    - scheduler pass time (GPIOR0 busy marker) and pass interval
+    adc     - microphone conversions per second on PB3 (GPIOR2 counter) and boot-to-first-sample time
+
+Limits (any violation is listed under "failures" and exits with status 1):
+    --min-pwm-hz HZ  --max-pwm-jitter-us US  --max-tuning-cents C
+    --max-loop-us US  --min-adc-sps N  --max-first-sample-ms MS
+
+Copyright (c) 2025 monkeyToneCircuits
+Licensed under CC-BY-NC 4.0
+"""
+
+import argparse
+import json
+import math
+import os
+import re
+import statistics
+import sys
+
+F_CPU = 8000000
+LED_PINS = {'PB0': 'LED_1ER', 'PB1': 'LED_5ER', 'PB2': 'LED_4ER', 'PB3': 'LED_3ER'}
+NOTE_SEMITONES = {'C': 0, 'CS': 1, 'D': 2, 'DS': 3, 'E': 4, 'F': 5, 'FS': 6, 'G': 7, 'GS': 8, 'A': 9, 'AS': 10, 'B': 11}
+REPO_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+
+TIMESCALE_NS = {'fs': 1e-6, 'ps': 1e-3, 'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def read_vcd(path):
+    """Change lists {signal name: [(time_ns, value), ...]} from a VCD file"""
+    names = {}
+    changes = {}
+    scale = 1.0
+    time_ns = 0.0
+    end_ns = 0.0
+
+    with open(path) as f:
+        tokens = iter(f.read().split())
+    for token in tokens:
+        if token == '$timescale':
+            spec = ''
+            for part in tokens:
+                if part == '$end':
+                    break
+                spec += part
+            number, unit = re.match(r'(\d+)\s*(\w+)', spec).groups()
+            scale = int(number) * TIMESCALE_NS[unit]
+        elif token == '$var':
+            fields = []
+            for part in tokens:
+                if part == '$end':
+                    break
+                fields.append(part)
+            names[fields[2]] = fields[3]  # $var wire <width> <id> <name> $end
+            changes[fields[3]] = []
+        elif token.startswith('$'):
+            if token not in ('$dumpvars', '$end'):
+                for part in tokens:  # Skip $comment, $date, $scope, ... blocks
+                    if part == '$end':
+                        break
+        elif token.startswith('#'):
+            time_ns = int(token[1:]) * scale
+            end_ns = max(end_ns, time_ns)
+        elif token[0] in 'bB':
+            value = token[1:]
+            ident = next(tokens)
+            if ident in names:
+                changes[names[ident]].append((time_ns, int(value, 2) if value.isdigit() else 0))
+        elif token[0] in '01xXzZ':
+            if token[1:] in names:
+                changes[names[token[1:]]].append((time_ns, 1 if token[0] == '1' else 0))
+
+    return changes, end_ns
+
+
+def summary(values, scale=1.0, digits=2):
+    if not values:
+        return None
+    ordered = sorted(values)
+    return {
+        'count': len(values),
+        'mean': round(statistics.mean(values) * scale, digits),
+        'min': round(ordered[0] * scale, digits),
+        'max': round(ordered[-1] * scale, digits),
+        'p99': round(ordered[min(len(ordered) - 1, int(len(ordered) * 0.99))] * scale, digits),
+    }
+
+
+# ============================================================================
+# PWM FRAMES
+# ============================================================================
+
+def pwm_report(changes):
+    report = {}
+    for pin, ring in LED_PINS.items():
+        rises = [t for t, v in changes.get(pin, []) if v == 1]
+        intervals = [b - a for a, b in zip(rises, rises[1:])]
+        if len(intervals) < 2:
+            report[pin] = {'ring': ring, 'frames': 0}
+            continue
+
+        # A ring held fully on or off skips its frame-start edge - keep single-frame gaps only
+        median = statistics.median(intervals)
+        frames = [i for i in intervals if 0.5 * median < i < 1.5 * median]
+        mean = statistics.mean(frames)
+        report[pin] = {
+            'ring': ring,
+            'frames': len(frames),
+            'frame_hz': round(1e9 / mean, 3),
+            'frame_us': round(mean / 1e3, 3),
+            'jitter_rms_us': round(statistics.pstdev(frames) / 1e3, 3),
+            'jitter_pp_us': round((max(frames) - min(frames)) / 1e3, 3),
+        }
+    return report
+
+
+# ============================================================================
+# SONG PITCH
+# ============================================================================
+
+def note_table():
+    """NOTE_* name -> (Hz, MIDI note) from lib/Audio/audio.h"""
+    table = {}
+    with open(os.path.join(REPO_DIR, 'lib', 'Audio', 'audio.h')) as f:
+        for name, octave, hz in re.findall(r'#define NOTE_([A-G]S?)(\d) (\d+)', f.read()):
+            table[name + octave] = (int(hz), 12 * (int(octave) + 1) + NOTE_SEMITONES[name])
+    return table
+
+
+def melody_names():
+    """melody_id_t value -> song name from the generated enum"""
+    with open(os.path.join(REPO_DIR, 'lib', 'Audio', 'audio_songs_generated.h')) as f:
+        enum = re.search(r'enum\s*\{(.*?)\}\s*melody_id_t', f.read(), re.S).group(1)
+    return [entry.split('=')[0].strip()[len('MELODY_'):] for entry in enum.split(',') if entry.strip()]
+
+
+def midi_frequency(note):
+    return 440.0 * 2 ** ((note - 69) / 12.0)
+
+
+def tone_events(changes):
+    """(time_ns, Hz) for every Timer1 start - f = F_CPU / (2^(CS1-1) * (OCR1C + 1))"""
+    events = sorted([(t, 0, v) for t, v in changes.get('OCR1C', [])] +
+                    [(t, 1, v) for t, v in changes.get('TCCR1', [])])
+    ocr1c = 0
+    clock_select = 0
+    tones = []
+    for t, kind, value in events:
+        if kind == 0:
+            ocr1c = value
+            continue
+        previous, clock_select = clock_select, value & 0x0F
+        if clock_select and clock_select != previous:
+            tones.append((t, F_CPU / (1 << (clock_select - 1)) / (ocr1c + 1)))
+    return tones
+
+
+def song_report(changes):
+    table = note_table()
+    names = melody_names()
+    melody = sorted(changes.get('MELODY', []))
+
+    songs = {}
+    for t, hz in tone_events(changes):
+        current = 0
+        for change_t, value in melody:
+            if change_t > t:
+                break
+            current = value
+        if current == 0:
+            continue  # Startup jingle or a breath-triggered tone outside the sequence
+
+        name = names[current] if current < len(names) else 'melody %d' % current
+        notated, (table_hz, note) = min(table.items(), key=lambda item: abs(math.log(hz / item[1][0])))
+        semitones = 69 + 12 * math.log2(hz / 440.0)
+        song = songs.setdefault(name, {'notated': [], 'tuning': [], 'worst': None})
+        song['notated'].append(1200 * math.log2(hz / midi_frequency(note)))
+        song['tuning'].append(100 * (semitones - round(semitones)))
+        if song['worst'] is None or abs(song['tuning'][-1]) > abs(song['worst']['tuning_cents']):
+            song['worst'] = {'note': notated, 'table_hz': table_hz, 'played_hz': round(hz, 2),
+                             'tuning_cents': round(song['tuning'][-1], 1)}
+
+    report = {}
+    for name, song in songs.items():
+        report[name] = {
+            'notes': len(song['tuning']),
+            'notated_cents_mean': round(statistics.mean(song['notated']), 1),
+            'notated_cents_max_abs': round(max(abs(c) for c in song['notated']), 1),
+            'tuning_cents_mean': round(statistics.mean(song['tuning']), 1),
+            'tuning_cents_max_abs': round(max(abs(c) for c in song['tuning']), 1),
+            'worst_note': song['worst'],
+        }
+    return report
+
+
+# ============================================================================
+# MAIN LOOP AND ADC
+# ============================================================================
+
+def loop_report(changes):
+    marks = changes.get('LOOP', [])
+    starts = [t for t, v in marks if v]
+    busy = []
+    start = None
+    for t, value in marks:
+        if value:
+            start = t
+        elif start is not None:
+            busy.append(t - start)
+            start = None
+    return {
+        'passes': len(busy),
+        'busy_us': summary(busy, 1e-3),
+        'interval_us': summary([b - a for a, b in zip(starts, starts[1:])], 1e-3),
+    }
+
+
+def adc_report(changes, end_ns):
+    samples = changes.get('ADC_SAMPLES', [])
+    # Power-on reset is t = 0 - the first counter increment is the first microphone sample the firmware sees
+    first = next((t for t, v in samples if v), None)
+    first_ms = round(first / 1e6, 3) if first is not None else None
+    if len(samples) < 2:
+        return {'samples': len(samples), 'samples_per_s': 0.0, 'first_sample_ms': first_ms}
+    span_ns = samples[-1][0] - samples[0][0]
+    count = len(samples) - 1  # Every marker write is one increment
+    return {
+        'samples': count,
+        'samples_per_s': round(count * 1e9 / span_ns, 1) if span_ns else 0.0,
+        'duty': round(span_ns / end_ns, 3) if end_ns else 0.0,
+        'first_sample_ms': first_ms,
+    }
+
+
+# ============================================================================
+# LIMITS
+# ============================================================================
+
+def check_limits(report, args):
+    failures = []
+    for pin, pwm in report['pwm'].items():
+        if pwm['frames'] == 0:
+            continue
+        if args.min_pwm_hz is not None and pwm['frame_hz'] < args.min_pwm_hz:
+            failures.append('%s frame rate %.2f Hz < %.2f' % (pin, pwm['frame_hz'], args.min_pwm_hz))
+        if args.max_pwm_jitter_us is not None and pwm['jitter_pp_us'] > args.max_pwm_jitter_us:
+            failures.append('%s jitter %.1f us > %.1f' % (pin, pwm['jitter_pp_us'], args.max_pwm_jitter_us))
+    for name, song in report['songs'].items():
+        if args.max_tuning_cents is not None and song['tuning_cents_max_abs'] > args.max_tuning_cents:
+            failures.append('%s off by %.1f cents > %.1f' % (name, song['tuning_cents_max_abs'], args.max_tuning_cents))
+    busy = report['loop']['busy_us']
+    if args.max_loop_us is not None and busy and busy['max'] > args.max_loop_us:
+        failures.append('main-loop pass %.0f us > %.0f' % (busy['max'], args.max_loop_us))
+    if args.min_adc_sps is not None and report['adc']['samples_per_s'] < args.min_adc_sps:
+        failures.append('ADC %.0f samples/s < %.0f' % (report['adc']['samples_per_s'], args.min_adc_sps))
+    first_ms = report['adc']['first_sample_ms']
+    if args.max_first_sample_ms is not None and (first_ms is None or first_ms > args.max_first_sample_ms):
+        failures.append('first microphone sample %s ms after reset > %.1f' % (first_ms, args.max_first_sample_ms))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('vcd')
+    parser.add_argument('-o', '--output', help='write the JSON report here instead of stdout')
+    parser.add_argument('--min-pwm-hz', type=float)
+    parser.add_argument('--max-pwm-jitter-us', type=float)
+    parser.add_argument('--max-tuning-cents', type=float)
+    parser.add_argument('--max-loop-us', type=float)
+    parser.add_argument('--min-adc-sps', type=float)
+    parser.add_argument('--max-first-sample-ms', type=float)
+    args = parser.parse_args()
+
+    changes, end_ns = read_vcd(args.vcd)
+    report = {
+        'simulated_s': round(end_ns / 1e9, 3),
+        'pwm': pwm_report(changes),
+        'songs': song_report(changes),
+        'loop': loop_report(changes),
+        'adc': adc_report(changes, end_ns),
+    }
+    report['failures'] = check_limits(report, args)
+
+    text = json.dumps(report, indent=2)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text + '\n')
+    else:
+        print(text)
+
+    for failure in report['failures']:
+        print('FAIL: ' + failure, file=sys.stderr)
+    return 1 if report['failures'] else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -17,14 +17,109 @@
 #if FEATURE_MICROPHONE_SENSOR
 #include "../lib/Sensors/sensors.h"
 #endif
+#include "../lib/Scheduler/scheduler.h"
+#include "../lib/Profiler/profiler.h"
+#include "../lib/Telemetry/telemetry.h"
 #include <avr/io.h>
-#include <util/delay.h>
+#include <avr/pgmspace.h>
+#if SIMULATION_MODE
+#include <avr/sleep.h>
+#endif
+
+#if !POWER_MEASUREMENT_MODE
+#if STANDBY_TIMEOUT_S > 0 && FEATURE_MICROPHONE_SENSOR
+// Nobody around: power down until a blow is sniffed on the microphone
+static void standby_update(void)
+{
+    if ((hardware_get_millis() - sensors_get_last_activity_time()) >= (uint32_t)STANDBY_TIMEOUT_S * 1000)
+    {
+        hardware_standby(sensors_get_wake_level());
+        sensors_notify_wake();
+        scheduler_resync(); // Ticks jumped by the time spent asleep - not an overrun
+    }
+}
+#endif
+
+#if PROF_ENABLED
+// Profile table to EEPROM - the blocking writes are not charged to the other tasks
+static void profiler_dump_update(void)
+{
+    profiler_dump();
+    scheduler_resync();
+}
+#endif
+
+#if SIMULATION_MODE && FEATURE_AUDIO_OUTPUT
+// simavr run: every melody once, back to back, then stop the simulator
+static void simulation_update(void)
+{
+    static uint8_t melody = MELODY_NONE;
+
+    if (audio_is_song_playing())
+    {
+        return;
+    }
+
+    if (++melody < MELODY_COUNT)
+    {
+        SIM_MARK_MELODY(melody);
+        audio_start_melody((melody_id_t)melody); // Songs left out of the build are skipped next poll
+        return;
+    }
+
+    SIM_MARK_MELODY(MELODY_NONE);
+    hardware_led_all_off();
+    cli();
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    sleep_cpu(); // Sleeping with interrupts off ends the simavr run
+}
+#endif
+
+// Periodic main-loop tasks, dispatched in table order when due
+static const scheduler_task_t main_tasks[] PROGMEM = {
+#if FEATURE_AUDIO_OUTPUT
+    {audio_update, 1}, // Non-blocking sequencer - steps notes and gaps
+#endif
+    {lighting_update, LIGHTING_FRAME_MS}, // Period set per effect by lighting_set_effect()
+    {lighting_interpolate, LIGHTING_SLEW_MS},
+#if FEATURE_MICROPHONE_SENSOR
+    // Breath monitoring stays live during songs (a new blow stops the song)
+    // The baseline keeps tracking through the post-song cooldown, triggers are held off inside
+    {sensors_update, SENSOR_UPDATE_RATE_MS},
+#endif
+#if STANDBY_TIMEOUT_S > 0 && FEATURE_MICROPHONE_SENSOR
+    {standby_update, STANDBY_CHECK_MS},
+#endif
+#if PROF_ENABLED
+    {profiler_dump_update, PROF_DUMP_MS},
+#endif
+#if TELEM_ENABLED
+    {telemetry_update, TELEMETRY_FRAME_MS},
+#endif
+#if SIMULATION_MODE && FEATURE_AUDIO_OUTPUT
+    {simulation_update, SIMULATION_CHECK_MS},
+#endif
+};
+#endif
 
 int main(void)
 {
+#if PROF_ENABLED
+    profiler_init(); // Before the Timer0 ISR probe starts recording
+#endif
+#if TELEM_ENABLED
+    telemetry_init();
+#endif
+
     // Initialize hardware systems
     hardware_init();
 
+#if !POWER_MEASUREMENT_MODE
+    // Task table first - lighting_init() sets the lighting_update() period of its effect
+    scheduler_init(main_tasks, sizeof(main_tasks) / sizeof(main_tasks[0]));
+#endif
+
     // Initialize lighting system - including Lighting mode (e.g. Candle Effect)
     lighting_init();
     
@@ -38,7 +133,26 @@ int main(void)
     audio_init();
 #endif
 
-    // Visual startup animation (blocking, ~1 second)
+#if POWER_MEASUREMENT_MODE
+    // Current-draw measurement: constant LED load, only the timer/ADC workload and the sleeping loop remain
+    uint8_t frame[LED_COUNT_MAX];
+    for (uint8_t led = 0; led < LED_COUNT_MAX; led++)
+    {
+        frame[led] = POWER_MEASUREMENT_BRIGHTNESS;
+    }
+    hardware_led_commit(frame);
+
+    while (1)
+    {
+        uint16_t sample;
+        while (hardware_microphone_pop(&sample))
+        {
+            // Drain the ADC queue like sensors_update() does
+        }
+        hardware_idle();
+    }
+#else
+    // Visual startup animation - a timed effect, breath sensing is live while it runs
     lighting_startup_animation();
 
     // Play startup melody using current song in rotation
@@ -46,19 +160,7 @@ int main(void)
     audio_play_next_melody();
 #endif
 
-    while (1)
-    {
-
-        hardware_update();
-        lighting_update();
-
-        // Only update sensor system if no song is playing and cooldown has expired
-        if (!audio_is_song_playing() && audio_is_cooldown_expired())
-        {
-            sensors_update(); // Re-enabled for Phase 2 testing
-        }
-
-        // Small delay to prevent excessive CPU usage
-        _delay_us(10);
-    }
+    // Hand the main loop to the scheduler - it sleeps between task deadlines
+    scheduler_run();
+#endif
 }
\ No newline at end of file
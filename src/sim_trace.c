@@ -0,0 +1,36 @@
+/*
+ * sim_trace.c - simavr trace setup for the attiny85_sim env
+ *
+ * Copyright (c) 2025 monkeyToneCircuits
+ * Licensed under CC-BY-NC 4.0
+ * https://creativecommons.org/licenses/by-nc/4.0/
+ *
+ * simavr reads the .mmcu section from firmware.elf: MCU, clock and the registers
+ * written to blinkytree_sim.vcd. Decode the trace with scripts/vcd_report.py.
+ * Empty in every other build - the section is not meant for a real chip.
+ */
+
+#include "../config/config.h"
+
+#if SIMULATION_MODE
+#include <avr/io.h>
+#include <avr/avr_mcu_section.h> // simavr headers (-I/usr/include/simavr in the attiny85_sim env)
+
+AVR_MCU(F_CPU, "attiny85");
+AVR_MCU_VCD_FILE("blinkytree_sim.vcd", 1000); // Flushed every 1000us of simulated time
+
+// Bit traces follow PORTB writes: the software PWM rings, PB3 while it drives LED_3ER.
+// OC1B drives PB4 from Timer1 in hardware, so the tone is taken from TCCR1/OCR1C instead.
+const struct avr_mmcu_vcd_trace_t blinkytree_sim_traces[] _MMCU_ = {
+    {AVR_MCU_VCD_SYMBOL("PB0"), .mask = (1 << PB0), .what = (void *)&PORTB},
+    {AVR_MCU_VCD_SYMBOL("PB1"), .mask = (1 << PB1), .what = (void *)&PORTB},
+    {AVR_MCU_VCD_SYMBOL("PB2"), .mask = (1 << PB2), .what = (void *)&PORTB},
+    {AVR_MCU_VCD_SYMBOL("PB3"), .mask = (1 << PB3), .what = (void *)&PORTB},
+    {AVR_MCU_VCD_SYMBOL("PB4"), .mask = (1 << PB4), .what = (void *)&PORTB},
+    {AVR_MCU_VCD_SYMBOL("TCCR1"), .mask = 0xFF, .what = (void *)&TCCR1},
+    {AVR_MCU_VCD_SYMBOL("OCR1C"), .mask = 0xFF, .what = (void *)&OCR1C},
+    {AVR_MCU_VCD_SYMBOL("LOOP"), .mask = 0xFF, .what = (void *)&GPIOR0},       // SIM_MARK_LOOP_BUSY/IDLE
+    {AVR_MCU_VCD_SYMBOL("MELODY"), .mask = 0xFF, .what = (void *)&GPIOR1},     // SIM_MARK_MELODY
+    {AVR_MCU_VCD_SYMBOL("ADC_SAMPLES"), .mask = 0xFF, .what = (void *)&GPIOR2}, // SIM_MARK_ADC_SAMPLE
+};
+#endif